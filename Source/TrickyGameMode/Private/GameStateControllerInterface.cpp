@@ -62,3 +62,122 @@ float IGameStateControllerInterface::GetGameRemainingTime_Implementation() const
 {
 	return -1.f;
 }
+
+FGameStateControllerCaller::FGameStateControllerCaller(UObject* InObject)
+{
+	if (!::IsValid(InObject) || !InObject->Implements<UGameStateControllerInterface>())
+	{
+		return;
+	}
+
+	Object = InObject;
+	NativeInterface = Cast<IGameStateControllerInterface>(InObject);
+
+	const UClass* Class = InObject->GetClass();
+	const TPair<FName, EFunction> Functions[] = {
+		{GET_FUNCTION_NAME_CHECKED(IGameStateControllerInterface, StartGame), EFunction::StartGame},
+		{GET_FUNCTION_NAME_CHECKED(IGameStateControllerInterface, FinishGame), EFunction::FinishGame},
+		{GET_FUNCTION_NAME_CHECKED(IGameStateControllerInterface, StopGame), EFunction::StopGame},
+		{GET_FUNCTION_NAME_CHECKED(IGameStateControllerInterface, ChangeInactivityReason), EFunction::ChangeInactivityReason},
+		{GET_FUNCTION_NAME_CHECKED(IGameStateControllerInterface, StartPreparation), EFunction::StartPreparation},
+		{GET_FUNCTION_NAME_CHECKED(IGameStateControllerInterface, StartCutscene), EFunction::StartCutscene},
+		{GET_FUNCTION_NAME_CHECKED(IGameStateControllerInterface, StartTransition), EFunction::StartTransition},
+		{GET_FUNCTION_NAME_CHECKED(IGameStateControllerInterface, GetGameState), EFunction::GetGameState},
+		{GET_FUNCTION_NAME_CHECKED(IGameStateControllerInterface, GetGameResult), EFunction::GetGameResult},
+		{GET_FUNCTION_NAME_CHECKED(IGameStateControllerInterface, GetGameInactivityReason), EFunction::GetGameInactivityReason},
+		{GET_FUNCTION_NAME_CHECKED(IGameStateControllerInterface, GetGameElapsedTime), EFunction::GetGameElapsedTime},
+		{GET_FUNCTION_NAME_CHECKED(IGameStateControllerInterface, GetGameRemainingTime), EFunction::GetGameRemainingTime}
+	};
+
+	for (const TPair<FName, EFunction>& Function : Functions)
+	{
+		if (Class->IsFunctionImplementedInScript(Function.Key))
+		{
+			ScriptFunctions |= static_cast<uint16>(Function.Value);
+		}
+	}
+}
+
+bool FGameStateControllerCaller::StartGame() const
+{
+	return IsNative(EFunction::StartGame)
+		       ? NativeInterface->StartGame_Implementation()
+		       : IGameStateControllerInterface::Execute_StartGame(Object);
+}
+
+bool FGameStateControllerCaller::FinishGame(const EGameResult Result) const
+{
+	return IsNative(EFunction::FinishGame)
+		       ? NativeInterface->FinishGame_Implementation(Result)
+		       : IGameStateControllerInterface::Execute_FinishGame(Object, Result);
+}
+
+bool FGameStateControllerCaller::StopGame(const EGameInactivityReason Reason) const
+{
+	return IsNative(EFunction::StopGame)
+		       ? NativeInterface->StopGame_Implementation(Reason)
+		       : IGameStateControllerInterface::Execute_StopGame(Object, Reason);
+}
+
+bool FGameStateControllerCaller::ChangeInactivityReason(const EGameInactivityReason NewInactivityReason) const
+{
+	return IsNative(EFunction::ChangeInactivityReason)
+		       ? NativeInterface->ChangeInactivityReason_Implementation(NewInactivityReason)
+		       : IGameStateControllerInterface::Execute_ChangeInactivityReason(Object, NewInactivityReason);
+}
+
+bool FGameStateControllerCaller::StartPreparation() const
+{
+	return IsNative(EFunction::StartPreparation)
+		       ? NativeInterface->StartPreparation_Implementation()
+		       : IGameStateControllerInterface::Execute_StartPreparation(Object);
+}
+
+bool FGameStateControllerCaller::StartCutscene() const
+{
+	return IsNative(EFunction::StartCutscene)
+		       ? NativeInterface->StartCutscene_Implementation()
+		       : IGameStateControllerInterface::Execute_StartCutscene(Object);
+}
+
+bool FGameStateControllerCaller::StartTransition() const
+{
+	return IsNative(EFunction::StartTransition)
+		       ? NativeInterface->StartTransition_Implementation()
+		       : IGameStateControllerInterface::Execute_StartTransition(Object);
+}
+
+ETrickyGameState FGameStateControllerCaller::GetGameState() const
+{
+	return IsNative(EFunction::GetGameState)
+		       ? NativeInterface->GetGameState_Implementation()
+		       : IGameStateControllerInterface::Execute_GetGameState(Object);
+}
+
+EGameResult FGameStateControllerCaller::GetGameResult() const
+{
+	return IsNative(EFunction::GetGameResult)
+		       ? NativeInterface->GetGameResult_Implementation()
+		       : IGameStateControllerInterface::Execute_GetGameResult(Object);
+}
+
+EGameInactivityReason FGameStateControllerCaller::GetGameInactivityReason() const
+{
+	return IsNative(EFunction::GetGameInactivityReason)
+		       ? NativeInterface->GetGameInactivityReason_Implementation()
+		       : IGameStateControllerInterface::Execute_GetGameInactivityReason(Object);
+}
+
+float FGameStateControllerCaller::GetGameElapsedTime() const
+{
+	return IsNative(EFunction::GetGameElapsedTime)
+		       ? NativeInterface->GetGameElapsedTime_Implementation()
+		       : IGameStateControllerInterface::Execute_GetGameElapsedTime(Object);
+}
+
+float FGameStateControllerCaller::GetGameRemainingTime() const
+{
+	return IsNative(EFunction::GetGameRemainingTime)
+		       ? NativeInterface->GetGameRemainingTime_Implementation()
+		       : IGameStateControllerInterface::Execute_GetGameRemainingTime(Object);
+}
@@ -0,0 +1,172 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyBroadcastProfiler.h"
+
+#if TRICKY_GAME_MODE_BROADCAST_PROFILER_ENABLED
+
+#include "GameStateControllerInterface.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/MiscTrace.h"
+
+namespace TrickyBroadcastProfiler
+{
+	static bool bIsEnabled = false;
+	static FAutoConsoleVariableRef CVarProfileBroadcasts(
+		TEXT("TrickyGameMode.ProfileBroadcasts"),
+		bIsEnabled,
+		TEXT("Measures the duration of each broadcast of TrickyGameModeBase events."));
+
+	static float BudgetMs = 16.6f;
+	static FAutoConsoleVariableRef CVarBroadcastBudgetMs(
+		TEXT("TrickyGameMode.BroadcastBudgetMs"),
+		BudgetMs,
+		TEXT("Broadcasts longer than this value in milliseconds log their slowest events."));
+
+	static int32 TopOffendersNum = 5;
+	static FAutoConsoleVariableRef CVarBroadcastTopOffenders(
+		TEXT("TrickyGameMode.BroadcastTopOffenders"),
+		TopOffendersNum,
+		TEXT("Number of the slowest events logged when a broadcast exceeds the budget."));
+
+	static FAutoConsoleCommand DumpBroadcastStatsCommand(
+		TEXT("TrickyGameMode.DumpBroadcastStats"),
+		TEXT("Logs the rolling percentiles of all measured TrickyGameModeBase events."),
+		FConsoleCommandDelegate::CreateStatic(&FTrickyBroadcastProfiler::DumpStats));
+}
+
+bool FTrickyBroadcastProfiler::IsEnabled()
+{
+	return TrickyBroadcastProfiler::bIsEnabled;
+}
+
+void FTrickyBroadcastProfiler::DumpStats()
+{
+	const FTrickyBroadcastProfiler& Profiler = Get();
+
+	for (const TPair<FName, FBroadcastStats>& Pair : Profiler.Stats)
+	{
+		const FBroadcastStats& BroadcastStats = Pair.Value;
+		UE_LOG(LogTrickyGameMode,
+		       Display,
+		       TEXT("%s: p50 %.3f ms, p95 %.3f ms, max %.3f ms, samples %d"),
+		       *Pair.Key.ToString(),
+		       BroadcastStats.GetPercentile(0.5f),
+		       BroadcastStats.GetPercentile(0.95f),
+		       BroadcastStats.GetPercentile(1.f),
+		       BroadcastStats.Samples.Num());
+	}
+}
+
+float FTrickyBroadcastProfiler::FBroadcastStats::GetPercentile(const float Percentile) const
+{
+	if (Samples.IsEmpty())
+	{
+		return 0.f;
+	}
+
+	TArray<float> SortedSamples = Samples;
+	SortedSamples.Sort();
+	const int32 Index = FMath::Clamp(FMath::CeilToInt32(Percentile * SortedSamples.Num()) - 1, 0, SortedSamples.Num() - 1);
+	return SortedSamples[Index];
+}
+
+FTrickyBroadcastProfiler& FTrickyBroadcastProfiler::Get()
+{
+	static FTrickyBroadcastProfiler Profiler;
+	return Profiler;
+}
+
+void FTrickyBroadcastProfiler::BeginBroadcast()
+{
+	if (SampleFrames.IsEmpty())
+	{
+		CurrentSamples.Reset();
+	}
+
+	SampleFrames.Add({FPlatformTime::Seconds(), 0.0});
+}
+
+void FTrickyBroadcastProfiler::EndBroadcast(const TCHAR* EventName)
+{
+	const FSampleFrame Frame = SampleFrames.Pop(EAllowShrinking::No);
+	const double Duration = FPlatformTime::Seconds() - Frame.StartTime;
+
+	// The whole duration of a nested broadcast belongs to the listener which triggered it.
+	if (!SampleFrames.IsEmpty())
+	{
+		SampleFrames.Last().NestedTime += Duration;
+	}
+
+	AddSample(FName(EventName), FMath::Max(Duration - Frame.NestedTime, 0.0));
+
+	if (SampleFrames.IsEmpty())
+	{
+		LogOverBudget(EventName);
+	}
+}
+
+void FTrickyBroadcastProfiler::AddSample(const FName EventName, const double Duration)
+{
+	FBroadcastStats& BroadcastStats = Stats.FindOrAdd(EventName);
+	const float DurationMs = static_cast<float>(Duration * 1000.0);
+
+	if (BroadcastStats.Samples.Num() < MaxSamplesNum)
+	{
+		BroadcastStats.Samples.Reserve(MaxSamplesNum);
+		BroadcastStats.Samples.Add(DurationMs);
+	}
+	else
+	{
+		BroadcastStats.Samples[BroadcastStats.NextSample] = DurationMs;
+	}
+
+	BroadcastStats.NextSample = (BroadcastStats.NextSample + 1) % MaxSamplesNum;
+	CurrentSamples.Add({EventName, DurationMs});
+}
+
+void FTrickyBroadcastProfiler::LogOverBudget(const TCHAR* EventName)
+{
+	float TotalMs = 0.f;
+
+	for (const FBroadcastSample& Sample : CurrentSamples)
+	{
+		TotalMs += Sample.DurationMs;
+	}
+
+	if (TotalMs <= TrickyBroadcastProfiler::BudgetMs)
+	{
+		return;
+	}
+
+	CurrentSamples.Sort([](const FBroadcastSample& A, const FBroadcastSample& B)
+	{
+		return A.DurationMs > B.DurationMs;
+	});
+
+	UE_LOG(LogTrickyGameMode,
+	       Warning,
+	       TEXT("%s broadcast took %.2f ms, budget is %.2f ms. Slowest events:"),
+	       EventName,
+	       TotalMs,
+	       TrickyBroadcastProfiler::BudgetMs);
+	TRACE_BOOKMARK(TEXT("TrickyGameMode %s over budget: %.2f ms"), EventName, TotalMs);
+
+	const int32 OffendersNum = FMath::Min(TrickyBroadcastProfiler::TopOffendersNum, CurrentSamples.Num());
+
+	for (int32 Index = 0; Index < OffendersNum; ++Index)
+	{
+		const FBroadcastSample& Sample = CurrentSamples[Index];
+		const FBroadcastStats& BroadcastStats = Stats.FindChecked(Sample.EventName);
+		UE_LOG(LogTrickyGameMode,
+		       Warning,
+		       TEXT("    %s: %.2f ms (p50 %.2f ms, p95 %.2f ms)"),
+		       *Sample.EventName.ToString(),
+		       Sample.DurationMs,
+		       BroadcastStats.GetPercentile(0.5f),
+		       BroadcastStats.GetPercentile(0.95f));
+	}
+}
+
+#endif
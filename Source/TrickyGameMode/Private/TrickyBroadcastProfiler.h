@@ -0,0 +1,92 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if !defined(TRICKY_GAME_MODE_BROADCAST_PROFILER_ENABLED)
+#define TRICKY_GAME_MODE_BROADCAST_PROFILER_ENABLED !UE_BUILD_SHIPPING
+#endif
+
+#if TRICKY_GAME_MODE_BROADCAST_PROFILER_ENABLED
+
+/**
+ * Measures how long the broadcasts of the game mode events take.
+ * Enabled with TrickyGameMode.ProfileBroadcasts 1. When a broadcast exceeds TrickyGameMode.BroadcastBudgetMs,
+ * the slowest events are logged with their rolling percentiles.
+ * Every delegate is broadcast by itself, so its listeners are invoked in their own order and measured as a whole.
+ * The time of the separate listeners is found in Unreal Insights under the CPU profiler scope of the broadcast.
+ * Every sample is the exclusive time of the broadcast, broadcasts nested in it are measured separately.
+ */
+class FTrickyBroadcastProfiler
+{
+public:
+	static bool IsEnabled();
+
+	template <typename DelegateType, typename... ArgTypes>
+	static void Broadcast(const TCHAR* EventName, DelegateType& Delegate, ArgTypes... Args)
+	{
+		FTrickyBroadcastProfiler& Profiler = Get();
+		Profiler.BeginBroadcast();
+		Delegate.Broadcast(Args...);
+		Profiler.EndBroadcast(EventName);
+	}
+
+	/**
+	 * Logs the rolling percentiles of all measured events.
+	 */
+	static void DumpStats();
+
+private:
+	struct FBroadcastStats
+	{
+		/**
+		 * Ring buffer of the last durations in milliseconds.
+		 */
+		TArray<float> Samples;
+
+		int32 NextSample = 0;
+
+		float GetPercentile(const float Percentile) const;
+	};
+
+	struct FBroadcastSample
+	{
+		FName EventName;
+
+		float DurationMs = 0.f;
+	};
+
+	/**
+	 * A broadcast being measured. Time of the broadcasts nested in it is subtracted from its duration.
+	 */
+	struct FSampleFrame
+	{
+		double StartTime = 0.0;
+
+		double NestedTime = 0.0;
+	};
+
+	static constexpr int32 MaxSamplesNum = 128;
+
+	TMap<FName, FBroadcastStats> Stats;
+
+	/**
+	 * Exclusive durations of the outermost broadcast in progress and the broadcasts nested in it.
+	 */
+	TArray<FBroadcastSample> CurrentSamples;
+
+	TArray<FSampleFrame> SampleFrames;
+
+	static FTrickyBroadcastProfiler& Get();
+
+	void BeginBroadcast();
+
+	void EndBroadcast(const TCHAR* EventName);
+
+	void AddSample(const FName EventName, const double Duration);
+
+	void LogOverBudget(const TCHAR* EventName);
+};
+
+#endif
@@ -0,0 +1,233 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyCountdownViewModel.h"
+
+#include "TrickyGameStateBase.h"
+#include "Engine/World.h"
+
+namespace TrickyCountdownViewModel
+{
+	/**
+	 * Updates are scheduled slightly after the step, so the rounded value has surely changed.
+	 */
+	static constexpr double UpdateDelayMargin = 0.001;
+}
+
+FDelegateHandle UTrickyCountdownViewModel::AddFieldValueChangedDelegate(UE::FieldNotification::FFieldId InFieldId,
+                                                                        FFieldValueChangedDelegate InNewDelegate)
+{
+	return InFieldId.IsValid() ? FieldDelegates.Add(this, InFieldId, MoveTemp(InNewDelegate)) : FDelegateHandle();
+}
+
+bool UTrickyCountdownViewModel::RemoveFieldValueChangedDelegate(UE::FieldNotification::FFieldId InFieldId,
+                                                                FDelegateHandle InHandle)
+{
+	return InFieldId.IsValid() && InHandle.IsValid() && FieldDelegates.RemoveFrom(this, InFieldId, InHandle).bRemoved;
+}
+
+int32 UTrickyCountdownViewModel::RemoveAllFieldValueChangedDelegates(FDelegateUserObjectConst InUserObject)
+{
+	return InUserObject ? FieldDelegates.RemoveAll(this, InUserObject).RemoveCount : 0;
+}
+
+int32 UTrickyCountdownViewModel::RemoveAllFieldValueChangedDelegates(UE::FieldNotification::FFieldId InFieldId,
+                                                                     FDelegateUserObjectConst InUserObject)
+{
+	return InFieldId.IsValid() && InUserObject ? FieldDelegates.RemoveAll(this, InFieldId, InUserObject).RemoveCount : 0;
+}
+
+void UTrickyCountdownViewModel::BroadcastFieldValueChanged(UE::FieldNotification::FFieldId InFieldId)
+{
+	if (InFieldId.IsValid())
+	{
+		FieldDelegates.Broadcast(this, InFieldId);
+	}
+}
+
+void UTrickyCountdownViewModel::Initialize(ATrickyGameStateBase* InGameState)
+{
+	OwningGameState = InGameState;
+	Refresh();
+}
+
+void UTrickyCountdownViewModel::Deinitialize()
+{
+	if (const ATrickyGameStateBase* CurrentGameState = OwningGameState.Get())
+	{
+		CurrentGameState->GetWorldTimerManager().ClearTimer(UpdateTimerHandle);
+	}
+
+	OwningGameState.Reset();
+}
+
+void UTrickyCountdownViewModel::Refresh()
+{
+	const ATrickyGameStateBase* CurrentGameState = OwningGameState.Get();
+
+	if (!IsValid(CurrentGameState))
+	{
+		return;
+	}
+
+	SetFieldValue(GameState,
+	              CurrentGameState->GetGameState_Implementation(),
+	              FFieldNotificationClassDescriptor::GameState);
+	SetFieldValue(InactivityReason,
+	              CurrentGameState->GetGameInactivityReason_Implementation(),
+	              FFieldNotificationClassDescriptor::InactivityReason);
+	SetFieldValue(GameResult,
+	              CurrentGameState->GetGameResult_Implementation(),
+	              FFieldNotificationClassDescriptor::GameResult);
+	UpdateTimers();
+}
+
+void UTrickyCountdownViewModel::SetGranularity(const ETrickyCountdownGranularity Value)
+{
+	if (Granularity == Value)
+	{
+		return;
+	}
+
+	Granularity = Value;
+	GameRemainingText = FormatTime(GameRemainingTime);
+	PreparationRemainingText = FormatTime(PreparationRemainingTime);
+	BroadcastFieldValueChanged(FFieldNotificationClassDescriptor::GameRemainingText);
+	BroadcastFieldValueChanged(FFieldNotificationClassDescriptor::PreparationRemainingText);
+	UpdateTimers();
+}
+
+double UTrickyCountdownViewModel::GetStep() const
+{
+	return Granularity == ETrickyCountdownGranularity::Tenths ? 0.1 : 1.0;
+}
+
+UTrickyCountdownViewModel::FTimerDisplay UTrickyCountdownViewModel::MakeTimerDisplay(const FTrickyTimerStamp& Stamp,
+                                                                                     const double Now) const
+{
+	FTimerDisplay Display;
+
+	if (!Stamp.IsActive())
+	{
+		return Display;
+	}
+
+	const double Step = GetStep();
+	const double Elapsed = Stamp.GetElapsed(Now);
+	const double ElapsedSteps = FMath::FloorToDouble(Elapsed / Step);
+	Display.ElapsedTime = static_cast<float>(ElapsedSteps * Step);
+	Display.RemainingTime = Display.ElapsedTime;
+
+	if (Stamp.IsPaused())
+	{
+		Display.NextUpdateDelay = -1.0;
+	}
+	else
+	{
+		Display.NextUpdateDelay = (ElapsedSteps + 1.0) * Step - Elapsed;
+	}
+
+	if (!Stamp.IsLimited())
+	{
+		return Display;
+	}
+
+	// Countdowns are rounded up, so they show 1 until the very end.
+	const double Remaining = Stamp.GetRemaining(Now);
+	const double RemainingSteps = FMath::CeilToDouble(Remaining / Step);
+	Display.RemainingTime = static_cast<float>(RemainingSteps * Step);
+
+	if (!Stamp.IsPaused() && Remaining > 0.0)
+	{
+		Display.NextUpdateDelay = FMath::Min(Display.NextUpdateDelay, Remaining - (RemainingSteps - 1.0) * Step);
+	}
+
+	return Display;
+}
+
+FText UTrickyCountdownViewModel::FormatTime(const float Time) const
+{
+	if (Time < 0.f)
+	{
+		return FText::GetEmpty();
+	}
+
+	switch (Granularity)
+	{
+	case ETrickyCountdownGranularity::Tenths:
+		{
+			FNumberFormattingOptions Options;
+			Options.MinimumFractionalDigits = 1;
+			Options.MaximumFractionalDigits = 1;
+			return FText::AsNumber(Time, &Options);
+		}
+
+	case ETrickyCountdownGranularity::MinutesSeconds:
+		{
+			const int32 Seconds = FMath::RoundToInt32(Time);
+			return FText::FromString(FString::Printf(TEXT("%02d:%02d"), Seconds / 60, Seconds % 60));
+		}
+
+	default:
+		return FText::AsNumber(FMath::RoundToInt32(Time));
+	}
+}
+
+void UTrickyCountdownViewModel::UpdateTimers()
+{
+	const ATrickyGameStateBase* CurrentGameState = OwningGameState.Get();
+
+	if (!IsValid(CurrentGameState))
+	{
+		return;
+	}
+
+	FTimerManager& TimerManager = CurrentGameState->GetWorldTimerManager();
+	TimerManager.ClearTimer(UpdateTimerHandle);
+
+	const double Now = CurrentGameState->GetServerWorldTimeSeconds();
+	const FTimerDisplay GameDisplay = MakeTimerDisplay(CurrentGameState->GetGameTimer(), Now);
+	const FTimerDisplay PreparationDisplay = MakeTimerDisplay(CurrentGameState->GetPreparationTimer(), Now);
+
+	SetFieldValue(GameElapsedTime, GameDisplay.ElapsedTime, FFieldNotificationClassDescriptor::GameElapsedTime);
+
+	if (SetFieldValue(GameRemainingTime,
+	                  GameDisplay.RemainingTime,
+	                  FFieldNotificationClassDescriptor::GameRemainingTime))
+	{
+		GameRemainingText = FormatTime(GameRemainingTime);
+		BroadcastFieldValueChanged(FFieldNotificationClassDescriptor::GameRemainingText);
+	}
+
+	SetFieldValue(PreparationElapsedTime,
+	              PreparationDisplay.ElapsedTime,
+	              FFieldNotificationClassDescriptor::PreparationElapsedTime);
+
+	if (SetFieldValue(PreparationRemainingTime,
+	                  PreparationDisplay.RemainingTime,
+	                  FFieldNotificationClassDescriptor::PreparationRemainingTime))
+	{
+		PreparationRemainingText = FormatTime(PreparationRemainingTime);
+		BroadcastFieldValueChanged(FFieldNotificationClassDescriptor::PreparationRemainingText);
+	}
+
+	double NextUpdateDelay = GameDisplay.NextUpdateDelay;
+
+	if (PreparationDisplay.NextUpdateDelay >= 0.0)
+	{
+		NextUpdateDelay = NextUpdateDelay >= 0.0
+			                  ? FMath::Min(NextUpdateDelay, PreparationDisplay.NextUpdateDelay)
+			                  : PreparationDisplay.NextUpdateDelay;
+	}
+
+	if (NextUpdateDelay < 0.0)
+	{
+		return;
+	}
+
+	TimerManager.SetTimer(UpdateTimerHandle,
+	                      this,
+	                      &UTrickyCountdownViewModel::UpdateTimers,
+	                      static_cast<float>(NextUpdateDelay + TrickyCountdownViewModel::UpdateDelayMargin),
+	                      false);
+}
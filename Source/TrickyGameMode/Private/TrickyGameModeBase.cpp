@@ -2,27 +2,177 @@
 
 
 #include "TrickyGameModeBase.h"
+#include "TrickyGameModeSubsystem.h"
+#include "TrickyGameStateBase.h"
+#include "TrickyReadyCheckComponent.h"
+#include "TrickyGameModeTrace.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
 #include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
 #include "TimerManager.h"
 
 DEFINE_LOG_CATEGORY(LogTrickyGameMode);
 
+/**
+ * Groups nested state and inactivity reason changes into a single transition.
+ */
+struct FTrickyTransitionScope
+{
+	explicit FTrickyTransitionScope(ATrickyGameModeBase* InGameMode)
+		: GameMode(InGameMode)
+	{
+		GameMode->BeginTransition();
+	}
+
+	~FTrickyTransitionScope()
+	{
+		GameMode->EndTransition();
+	}
+
+private:
+	ATrickyGameModeBase* GameMode = nullptr;
+};
+
+ATrickyGameModeBase::ATrickyGameModeBase()
+{
+	GameStateClass = ATrickyGameStateBase::StaticClass();
+
+	// Ticks only while there are deferred transition listeners. Pausing the world is a transition too,
+	// so its listeners must be drained while the world is paused.
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	PrimaryActorTick.bTickEvenWhenPaused = true;
+}
+
+void ATrickyGameModeBase::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	SelfCaller = FGameStateControllerCaller(this);
+}
+
 void ATrickyGameModeBase::StartPlay()
 {
 	Super::StartPlay();
 
-	CurrentInactivityReason = InitialInactivityReason;
-	OnGameStopped.Broadcast(CurrentInactivityReason);
+	EnterInitialState();
+}
 
-	if (CurrentInactivityReason == EGameInactivityReason::Preparation && PreparationDuration > 0.0f)
+void ATrickyGameModeBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UTrickyGameModeSubsystem* Subsystem = UTrickyGameModeSubsystem::Get(this))
 	{
-		StartPreparationTimer();
+		Subsystem->ResetGameStateController(this);
+	}
+
+	TaskWaits.CancelAll();
+	TickPolicies.Reset();
+	RestoreServerTickRate();
+	Super::EndPlay(EndPlayReason);
+}
+
+void ATrickyGameModeBase::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(ATrickyGameModeBase::DispatchDeferredListeners);
+
+	if (!TransitionDispatcher.DispatchDeferred(DeferredListenersBudgetMs / 1000.0))
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+void ATrickyGameModeBase::GenericPlayerInitialization(AController* C)
+{
+	Super::GenericPlayerInitialization(C);
+
+	RegisterPlayer(C);
+	UpdateServerTickRate();
+}
+
+void ATrickyGameModeBase::Logout(AController* Exiting)
+{
+	UnregisterPlayer(Exiting);
+	Super::Logout(Exiting);
+	UpdateServerTickRate(Exiting);
+}
+
+FDelegateHandle ATrickyGameModeBase::SubscribeToTransition(const FTrickyTransitionFilter& Filter,
+                                                           FOnGameStateTransitionSignature::FDelegate&& Delegate,
+                                                           const FTrickyTransitionListenerOptions& Options)
+{
+	return TransitionDispatcher.Subscribe(Filter, MoveTemp(Delegate), Options);
+}
+
+bool ATrickyGameModeBase::UnsubscribeFromTransition(const FDelegateHandle Handle)
+{
+	return TransitionDispatcher.Unsubscribe(Handle);
+}
+
+UE::Tasks::TTask<bool> ATrickyGameModeBase::WaitForTransition(const FTrickyTransitionFilter& Filter)
+{
+	const FTrickyTaskWaitList::FWaitRef Wait = TaskWaits.Add();
+	const FDelegateHandle Handle = SubscribeToTransition(
+		Filter,
+		FOnGameStateTransitionSignature::FDelegate::CreateWeakLambda(
+			this,
+			[this, Wait](const FTrickyGameStateTransition& Transition)
+			{
+				TaskWaits.Complete(Wait, true);
+			}));
+	Wait->Unsubscribe = [this, Handle]() { UnsubscribeFromTransition(Handle); };
+	return FTrickyTaskWaitList::MakeTask(Wait);
+}
+
+UE::Tasks::TTask<bool> ATrickyGameModeBase::WaitForGameState(const ETrickyGameState State)
+{
+	if (CurrentState != State)
+	{
+		return WaitForTransition(FTrickyTransitionFilter::MakeTo(State));
 	}
+
+	const FTrickyTaskWaitList::FWaitRef Wait = TaskWaits.Add();
+	TaskWaits.Complete(Wait, true);
+	return FTrickyTaskWaitList::MakeTask(Wait);
+}
+
+UE::Tasks::TTask<bool> ATrickyGameModeBase::WaitForPreparationMilestone(const FTrickyTimerMilestone& Milestone)
+{
+	return WaitForMilestone(Milestone, true);
+}
+
+UE::Tasks::TTask<bool> ATrickyGameModeBase::WaitForGameMilestone(const FTrickyTimerMilestone& Milestone)
+{
+	return WaitForMilestone(Milestone, false);
+}
+
+bool ATrickyGameModeBase::RegisterTickPolicy(UObject* Object, const FTrickyTickPolicy& Policy)
+{
+	return TickPolicies.Register(Object, Policy);
+}
+
+bool ATrickyGameModeBase::UnregisterTickPolicy(UObject* Object)
+{
+	return TickPolicies.Unregister(Object);
+}
+
+FDelegateHandle ATrickyGameModeBase::RegisterTickPolicyDelegate(const FTrickyTickPolicy& Policy,
+                                                                FOnTickModeChangedSignature&& Delegate)
+{
+	return TickPolicies.Register(Policy, MoveTemp(Delegate));
+}
+
+bool ATrickyGameModeBase::UnregisterTickPolicyDelegate(const FDelegateHandle Handle)
+{
+	return TickPolicies.Unregister(Handle);
 }
 
 bool ATrickyGameModeBase::SetPause(APlayerController* PC, FCanUnpause CanUnpauseDelegate)
 {
-	if (!Execute_StopGame(this, EGameInactivityReason::Paused))
+	if (!SelfCaller.StopGame(EGameInactivityReason::Paused))
 	{
 		return false;
 	}
@@ -37,10 +187,243 @@ bool ATrickyGameModeBase::ClearPause()
 		return false;
 	}
 
-	ChangeGameState(LastState);
+	{
+		FTrickyTransitionScope TransitionScope(this);
+		ChangeGameState(LastState);
+		SelfCaller.ChangeInactivityReason(EGameInactivityReason::None);
+	}
+
 	return Super::ClearPause();
 }
 
+bool ATrickyGameModeBase::SetPlayerReady(AController* Player, const bool bIsReady)
+{
+	const int32* Slot = PlayerSlots.Find(Player);
+
+	if (!Slot || !ReadyCheck.SetReady(*Slot, bIsReady))
+	{
+		return false;
+	}
+
+	UpdateReplicatedReadyCheck();
+	TryCompleteReadyCheck();
+	return true;
+}
+
+int32 ATrickyGameModeBase::GetPlayerSlot(const AController* Player) const
+{
+	const int32* Slot = PlayerSlots.Find(Player);
+	return Slot ? *Slot : INDEX_NONE;
+}
+
+bool ATrickyGameModeBase::Rematch()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(ATrickyGameModeBase::Rematch);
+
+	const UWorld* World = GetWorld();
+
+	if (!IsValid(World) || !World->IsGameWorld() || !HasActorBegunPlay())
+	{
+		return false;
+	}
+
+	FTrickyTransitionScope TransitionScope(this);
+
+	// Paused timers can't be stopped, so they're unpaused first.
+	UnPausePreparationTimer();
+	StopPreparationTimer();
+	UnPauseGameTimer();
+	StopGameTimer();
+	SessionClock.Reset();
+	UpdateReplicatedTimers();
+
+	GameResult = EGameResult::None;
+	CurrentRound = 0;
+	RoundResults.Reset();
+	UpdateReplicatedRound();
+	Participants.ResetResults();
+	ReadyCheck.ResetReady();
+	UpdateReplicatedReadyCheck();
+
+	if (UTrickyGameModeSubsystem* Subsystem = UTrickyGameModeSubsystem::Get(this))
+	{
+		Subsystem->GetRematchRegistry().ResetAll();
+	}
+
+	ChangeGameState(ETrickyGameState::Inactive);
+	EnterInitialState();
+	TRICKY_GAME_MODE_BROADCAST(OnRematchStarted);
+	PendingNativeEvents.Add(ETrickyNativeTransitionEvent::RematchStarted);
+
+#if WITH_EDITOR || !UE_BUILD_SHIPPING
+	UE_LOG(LogTrickyGameMode, Display, TEXT("Rematch Started"));
+#endif
+
+	return true;
+}
+
+bool ATrickyGameModeBase::FinishRound(const EGameResult Result)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(ATrickyGameModeBase::FinishRound);
+
+	if (!bIsRoundBased || CurrentState != ETrickyGameState::Active || CurrentRound == 0)
+	{
+		return false;
+	}
+
+	RoundResults.Add(Result);
+
+	if (bIsSessionTimeLimited)
+	{
+		StopGameTimer();
+	}
+	TRICKY_GAME_MODE_BROADCAST(OnRoundFinished, CurrentRound, Result);
+
+#if WITH_EDITOR || !UE_BUILD_SHIPPING
+	UE_LOG(LogTrickyGameMode, Display, TEXT("Round %d Finished with Result: %s"), CurrentRound, LexToString(Result));
+#endif
+
+	if (IsMatchDecided())
+	{
+		return SelfCaller.FinishGame(CalculateMatchResult());
+	}
+
+	if (!SelfCaller.StartPreparation())
+	{
+		return false;
+	}
+
+	// StartPreparation doesn't start the timer when it stops an active game.
+	// Without the inter-round preparation there's no timer to start the next round.
+	return GetPreparationTimerDuration() > 0.0f ? StartPreparationTimer() : SelfCaller.StartGame();
+}
+
+int32 ATrickyGameModeBase::GetRoundsNumWithResult(const EGameResult Result) const
+{
+	return RoundResults.FilterByPredicate([Result](const EGameResult RoundResult)
+	{
+		return RoundResult == Result;
+	}).Num();
+}
+
+int32 ATrickyGameModeBase::RegisterPlayer(AController* Player)
+{
+	if (!IsValid(Player))
+	{
+		return INDEX_NONE;
+	}
+
+	if (const int32* ExistingSlot = PlayerSlots.Find(Player))
+	{
+		return *ExistingSlot;
+	}
+
+	const int32 Slot = ReadyCheck.AddPlayer();
+	PlayerSlots.Add(Player, Slot);
+
+	if (Slot >= SlotPlayers.Num())
+	{
+		SlotPlayers.SetNum(Slot + 1);
+	}
+
+	SlotPlayers[Slot] = Player;
+	Participants.AddPlayer(Slot);
+	UpdateReplicatedReadyCheck();
+
+	if (!IsValid(Player->PlayerState))
+	{
+		return Slot;
+	}
+
+	UTrickyReadyCheckComponent* Component = Player->PlayerState->FindComponentByClass<UTrickyReadyCheckComponent>();
+
+	if (IsValid(Component))
+	{
+		Component->SetPlayerSlot(Slot);
+	}
+
+	return Slot;
+}
+
+bool ATrickyGameModeBase::UnregisterPlayer(AController* Player)
+{
+	int32 Slot = INDEX_NONE;
+
+	if (!PlayerSlots.RemoveAndCopyValue(Player, Slot))
+	{
+		return false;
+	}
+
+	const int32 Team = Participants.GetPlayerTeam(Slot);
+	const bool bWasAlive = Participants.IsPlayerAlive(Slot);
+	Participants.RemovePlayer(Slot);
+	SlotPlayers[Slot] = nullptr;
+	ReadyCheck.RemovePlayer(Slot);
+	UpdateReplicatedReadyCheck();
+
+	if (bWasAlive && Participants.GetTeamState(Team) == ETrickyGameState::Finished)
+	{
+		TRICKY_GAME_MODE_BROADCAST(OnTeamFinished, Team, Participants.GetTeamResult(Team));
+	}
+
+	// The leaving player might have been the last one who wasn't ready or the last opponent.
+	TryCompleteReadyCheck();
+	TryAutoFinishGame();
+	return true;
+}
+
+bool ATrickyGameModeBase::SetPlayerTeam(AController* Player, const int32 Team)
+{
+	const int32* Slot = PlayerSlots.Find(Player);
+	return Slot && Participants.SetPlayerTeam(*Slot, Team);
+}
+
+bool ATrickyGameModeBase::FinishPlayer(AController* Player, const EGameResult Result)
+{
+	const int32* Slot = PlayerSlots.Find(Player);
+
+	if (!Slot || !Participants.IsPlayerAlive(*Slot))
+	{
+		return false;
+	}
+
+	FinishPlayersInSlots({*Slot}, Result);
+	TryAutoFinishGame();
+	return true;
+}
+
+bool ATrickyGameModeBase::FinishTeam(const int32 Team, const EGameResult Result)
+{
+	if (Team == INDEX_NONE || Participants.GetTeamAliveNum(Team) == 0)
+	{
+		return false;
+	}
+
+	TArray<int32> TeamSlots;
+
+	for (int32 Slot = 0; Slot < Participants.GetSlotsNum(); ++Slot)
+	{
+		if (Participants.GetPlayerTeam(Slot) == Team && Participants.IsPlayerAlive(Slot))
+		{
+			TeamSlots.Add(Slot);
+		}
+	}
+
+	FinishPlayersInSlots(TeamSlots, Result);
+	TryAutoFinishGame();
+	return true;
+}
+
+ETrickyGameState ATrickyGameModeBase::GetPlayerGameState(const AController* Player) const
+{
+	return Participants.GetPlayerState(GetPlayerSlot(Player));
+}
+
+EGameResult ATrickyGameModeBase::GetPlayerGameResult(const AController* Player) const
+{
+	return Participants.GetPlayerResult(GetPlayerSlot(Player));
+}
+
 void ATrickyGameModeBase::SetPreparationDuration(const float Value)
 {
 	if (Value < 0.0f)
@@ -51,6 +434,77 @@ void ATrickyGameModeBase::SetPreparationDuration(const float Value)
 	PreparationDuration = Value;
 }
 
+void ATrickyGameModeBase::SetIsRoundBased(const bool Value)
+{
+	bIsRoundBased = Value;
+}
+
+void ATrickyGameModeBase::SetRoundsNum(const int32 Value)
+{
+	if (Value < 1)
+	{
+		return;
+	}
+
+	RoundsNum = Value;
+}
+
+void ATrickyGameModeBase::SetRoundPreparationDuration(const float Value)
+{
+	if (Value < 0.0f)
+	{
+		return;
+	}
+
+	RoundPreparationDuration = Value;
+}
+
+void ATrickyGameModeBase::SetAutoFinishCondition(const ETrickyAutoFinishCondition Value)
+{
+	AutoFinishCondition = Value;
+}
+
+void ATrickyGameModeBase::SetIsReadyCheckEnabled(const bool Value)
+{
+	bIsReadyCheckEnabled = Value;
+}
+
+void ATrickyGameModeBase::SetReadyCheckQuorum(const float Value)
+{
+	if (Value < 0.0f || Value > 1.0f)
+	{
+		return;
+	}
+
+	ReadyCheckQuorum = Value;
+}
+
+void ATrickyGameModeBase::SetReadyCheckTimeout(const float Value)
+{
+	if (Value < 0.0f)
+	{
+		return;
+	}
+
+	ReadyCheckTimeout = Value;
+}
+
+void ATrickyGameModeBase::SetDeferredListenersBudgetMs(const float Value)
+{
+	if (Value < 0.0f)
+	{
+		return;
+	}
+
+	DeferredListenersBudgetMs = Value;
+}
+
+void ATrickyGameModeBase::SetServerTickRates(const FTrickyServerTickRates& Value)
+{
+	ServerTickRates = Value;
+	UpdateServerTickRate();
+}
+
 void ATrickyGameModeBase::SetIsSessionTimeLimited(const bool Value)
 {
 	bIsSessionTimeLimited = Value;
@@ -88,13 +542,19 @@ void ATrickyGameModeBase::SetInitialInactivityReason(const EGameInactivityReason
 
 bool ATrickyGameModeBase::StartGame_Implementation()
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(ATrickyGameModeBase::StartGame_Implementation);
+
 	if (CurrentState == ETrickyGameState::Active)
 	{
 		return false;
 	}
 
+	FTrickyTransitionScope TransitionScope(this);
 	ChangeGameState(ETrickyGameState::Active);
-	Execute_ChangeInactivityReason(this, EGameInactivityReason::None);
+	SelfCaller.ChangeInactivityReason(EGameInactivityReason::None);
+
+	// Every round records its result, so a recorded result of the current round means a new round.
+	const bool bIsNewRound = bIsRoundBased && (CurrentRound == 0 || RoundResults.Num() >= CurrentRound);
 
 	if (bIsSessionTimeLimited)
 	{
@@ -102,13 +562,28 @@ bool ATrickyGameModeBase::StartGame_Implementation()
 	}
 	else
 	{
-		StartGameTime = GetWorld()->GetTimeSeconds();
+		// Sessions without a time limit measure the time since the last start, as they always did.
+		SessionClock.GameTimer.Start(GetWorld()->GetTimeSeconds(), 0.f);
+		UpdateReplicatedTimers();
 	}
 
-	OnGameStarted.Broadcast();
+	TRICKY_GAME_MODE_BROADCAST(OnGameStarted);
+	PendingNativeEvents.Add(ETrickyNativeTransitionEvent::GameStarted);
+
+	if (bIsNewRound)
+	{
+		++CurrentRound;
+		Participants.ResetResults();
+		UpdateReplicatedRound();
+		TRICKY_GAME_MODE_BROADCAST(OnRoundStarted, CurrentRound);
 
 #if WITH_EDITOR || !UE_BUILD_SHIPPING
-	PrintLog("Game Started");
+		UE_LOG(LogTrickyGameMode, Display, TEXT("Round %d Started"), CurrentRound);
+#endif
+	}
+
+#if WITH_EDITOR || !UE_BUILD_SHIPPING
+	UE_LOG(LogTrickyGameMode, Display, TEXT("Game Started"));
 #endif
 
 	return true;
@@ -116,19 +591,21 @@ bool ATrickyGameModeBase::StartGame_Implementation()
 
 bool ATrickyGameModeBase::FinishGame_Implementation(const EGameResult Result)
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(ATrickyGameModeBase::FinishGame_Implementation);
+
 	if (CurrentState == ETrickyGameState::Finished)
 	{
 		return false;
 	}
 
-	ChangeGameState(ETrickyGameState::Finished);
+	FTrickyTransitionScope TransitionScope(this);
 	GameResult = Result;
-	OnGameFinished.Broadcast(Result);
+	ChangeGameState(ETrickyGameState::Finished);
+	TRICKY_GAME_MODE_BROADCAST(OnGameFinished, Result);
+	PendingNativeEvents.Add(ETrickyNativeTransitionEvent::GameFinished);
 
 #if WITH_EDITOR || !UE_BUILD_SHIPPING
-	FString ResultName = "NONE";
-	GetGameResultName(ResultName, Result);
-	PrintLog(FString::Printf(TEXT("Game Finished with Result: %s"), *ResultName));
+	UE_LOG(LogTrickyGameMode, Display, TEXT("Game Finished with Result: %s"), LexToString(Result));
 #endif
 
 	return true;
@@ -136,19 +613,21 @@ bool ATrickyGameModeBase::FinishGame_Implementation(const EGameResult Result)
 
 bool ATrickyGameModeBase::StopGame_Implementation(const EGameInactivityReason Reason)
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(ATrickyGameModeBase::StopGame_Implementation);
+
 	if (CurrentState == ETrickyGameState::Inactive)
 	{
 		return false;
 	}
 
+	FTrickyTransitionScope TransitionScope(this);
 	ChangeGameState(ETrickyGameState::Inactive);
-	Execute_ChangeInactivityReason(this, Reason);
-	OnGameStopped.Broadcast(Reason);
+	SelfCaller.ChangeInactivityReason(Reason);
+	TRICKY_GAME_MODE_BROADCAST(OnGameStopped, Reason);
+	PendingNativeEvents.Add(ETrickyNativeTransitionEvent::GameStopped);
 
 #if WITH_EDITOR || !UE_BUILD_SHIPPING
-	FString ReasonName = "NONE";
-	GetInactivityReasonName(ReasonName, Reason);
-	PrintLog(FString::Printf(TEXT("Game Stopped with Reason: %s"), *ReasonName));
+	UE_LOG(LogTrickyGameMode, Display, TEXT("Game Stopped with Reason: %s"), LexToString(Reason));
 #endif
 	return true;
 }
@@ -157,15 +636,21 @@ bool ATrickyGameModeBase::StartPreparation_Implementation()
 {
 	if (CurrentState != ETrickyGameState::Inactive)
 	{
-		return StopGame(EGameInactivityReason::Preparation);
+		return SelfCaller.StopGame(EGameInactivityReason::Preparation);
 	}
 
-	if (!Execute_ChangeInactivityReason(this, EGameInactivityReason::Preparation))
+	if (!SelfCaller.ChangeInactivityReason(EGameInactivityReason::Preparation))
 	{
 		return false;
 	}
 
-	if (PreparationDuration > 0.0f)
+	if (bIsReadyCheckEnabled && !IsBetweenRounds())
+	{
+		ReadyCheck.ResetReady();
+		UpdateReplicatedReadyCheck();
+	}
+
+	if (GetPreparationTimerDuration() > 0.0f)
 	{
 		StartPreparationTimer();
 	}
@@ -176,20 +661,20 @@ bool ATrickyGameModeBase::StartCutscene_Implementation()
 {
 	if (CurrentState != ETrickyGameState::Inactive)
 	{
-		return StopGame(EGameInactivityReason::Cutscene);
+		return SelfCaller.StopGame(EGameInactivityReason::Cutscene);
 	}
 
-	return Execute_ChangeInactivityReason(this, EGameInactivityReason::Cutscene);
+	return SelfCaller.ChangeInactivityReason(EGameInactivityReason::Cutscene);
 }
 
 bool ATrickyGameModeBase::StartTransition_Implementation()
 {
 	if (CurrentState != ETrickyGameState::Inactive)
 	{
-		return StopGame(EGameInactivityReason::Transition);
+		return SelfCaller.StopGame(EGameInactivityReason::Transition);
 	}
 
-	return Execute_ChangeInactivityReason(this, EGameInactivityReason::Transition);
+	return SelfCaller.ChangeInactivityReason(EGameInactivityReason::Transition);
 }
 
 ETrickyGameState ATrickyGameModeBase::GetGameState_Implementation() const
@@ -220,49 +705,63 @@ EGameInactivityReason ATrickyGameModeBase::GetGameInactivityReason_Implementatio
 float ATrickyGameModeBase::GetGameElapsedTime_Implementation() const
 {
 	const UWorld* World = GetWorld();
-	float ElapsedTime = -1.f;
 
 	if (!IsValid(World) || !World->IsGameWorld())
 	{
-		return ElapsedTime;
+		return -1.f;
+	}
+
+	// Before the first start a session without a time limit reports the time since the world start.
+	if (!bIsSessionTimeLimited && !SessionClock.GameTimer.IsActive())
+	{
+		return static_cast<float>(World->GetTimeSeconds());
 	}
 
-	ElapsedTime = bIsSessionTimeLimited
-		              ? GetWorldTimerManager().GetTimerElapsed(GameTimerHandle)
-		              : GetWorld()->GetTimeSeconds() - StartGameTime;
-	return ElapsedTime;
+	return static_cast<float>(SessionClock.GetGameElapsed(World->GetTimeSeconds()));
 }
 
 float ATrickyGameModeBase::GetGameRemainingTime_Implementation() const
 {
 	const UWorld* World = GetWorld();
-	float ElapsedTime = -1.f;
 
 	if (!IsValid(World) || !World->IsGameWorld())
 	{
-		return ElapsedTime;
+		return -1.f;
 	}
 
-	ElapsedTime = bIsSessionTimeLimited
-		              ? GetWorldTimerManager().GetTimerRemaining(GameTimerHandle)
-		              : GetWorld()->GetTimeSeconds() - StartGameTime;
-	return ElapsedTime;
+	if (!bIsSessionTimeLimited && !SessionClock.GameTimer.IsActive())
+	{
+		return static_cast<float>(World->GetTimeSeconds());
+	}
+
+	return static_cast<float>(SessionClock.GetGameRemaining(World->GetTimeSeconds()));
 }
 
 bool ATrickyGameModeBase::ChangeInactivityReason_Implementation(const EGameInactivityReason NewInactivityReason)
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(ATrickyGameModeBase::ChangeInactivityReason_Implementation);
+
 	if (CurrentInactivityReason == NewInactivityReason)
 	{
 		return false;
 	}
 
+	FTrickyTransitionScope TransitionScope(this);
 	CurrentInactivityReason = NewInactivityReason;
-	OnInactivityReasonChanged.Broadcast(CurrentInactivityReason);
+
+	if (CurrentState == ETrickyGameState::Inactive)
+	{
+		SessionClock.StartPhase(GetWorld()->GetTimeSeconds());
+	}
+
+	UpdateReplicatedState();
+	TRICKY_GAME_MODE_BROADCAST(OnInactivityReasonChanged, CurrentInactivityReason);
 
 #if WITH_EDITOR || !UE_BUILD_SHIPPING
-	FString ReasonName = "NONE";
-	GetInactivityReasonName(ReasonName, CurrentInactivityReason);
-	PrintLog(FString::Printf(TEXT("Inactivity Reason changed to: %s"), *ReasonName));
+	UE_LOG(LogTrickyGameMode,
+	       Display,
+	       TEXT("Inactivity Reason changed to: %s"),
+	       LexToString(CurrentInactivityReason));
 #endif
 
 	return true;
@@ -272,28 +771,25 @@ bool ATrickyGameModeBase::StartPreparationTimer()
 {
 	const UWorld* World = GetWorld();
 
-	if (!IsValid(World) || !World->IsGameWorld())
+	if (!IsValid(World) || !World->IsGameWorld() || SessionClock.PreparationTimer.IsActive())
 	{
 		return false;
 	}
 
-	FTimerManager& TimerManager = World->GetTimerManager();
-
-	if (TimerManager.IsTimerActive(PreparationTimerHandle))
-	{
-		return false;
-	}
-
-	TimerManager.SetTimer(PreparationTimerHandle,
-	                      this,
-	                      &ATrickyGameModeBase::HandlePreparationTimerFinished,
-	                      PreparationDuration,
-	                      false);
-	OnPreparationTimerStarted.Broadcast(PreparationDuration);
+	const float Duration = GetPreparationTimerDuration();
+	World->GetTimerManager().SetTimer(PreparationTimerHandle,
+	                                  this,
+	                                  &ATrickyGameModeBase::HandlePreparationTimerFinished,
+	                                  Duration,
+	                                  false);
+	SessionClock.PreparationTimer.Start(World->GetTimeSeconds(), Duration);
+	UpdateReplicatedTimers();
+	TRACE_TRICKY_GAME_MODE_TIMER(this, Preparation, Start, World->GetTimeSeconds(), Duration);
+	TRICKY_GAME_MODE_BROADCAST(OnPreparationTimerStarted, Duration);
+	TRICKY_GAME_MODE_BROADCAST(OnPreparationTimerStartedNative, Duration);
 
 #if WITH_EDITOR || !UE_BUILD_SHIPPING
-	const FString LogMessage = FString::Printf(TEXT("Preparation Timer started. Duration: %.2f"), PreparationDuration);
-	PrintLog(LogMessage);
+	UE_LOG(LogTrickyGameMode, Display, TEXT("Preparation Timer started. Duration: %.2f"), Duration);
 #endif
 
 	return true;
@@ -301,195 +797,368 @@ bool ATrickyGameModeBase::StartPreparationTimer()
 
 void ATrickyGameModeBase::HandlePreparationTimerFinished()
 {
-	Execute_StartGame(this);
+	TRACE_CPUPROFILER_EVENT_SCOPE(ATrickyGameModeBase::HandlePreparationTimerFinished);
+
+	TRACE_TRICKY_GAME_MODE_TIMER(this,
+	                             Preparation,
+	                             Finish,
+	                             GetWorld()->GetTimeSeconds(),
+	                             SessionClock.PreparationTimer.Duration);
+	PreparationTimerHandle.Invalidate();
+	SessionClock.PreparationTimer.Stop();
+	UpdateReplicatedTimers();
+	SelfCaller.StartGame();
 }
 
-bool ATrickyGameModeBase::StopPreparationTimer()
+void ATrickyGameModeBase::EnterInitialState()
 {
-	const UWorld* World = GetWorld();
+	FTrickyTransitionScope TransitionScope(this);
+	LastState = ETrickyGameState::Inactive;
+	CurrentInactivityReason = InitialInactivityReason;
+	SessionClock.StartPhase(GetWorld()->GetTimeSeconds());
+	UpdateReplicatedState();
+	TRICKY_GAME_MODE_BROADCAST(OnGameStopped, CurrentInactivityReason);
+	PendingNativeEvents.Add(ETrickyNativeTransitionEvent::GameStopped);
 
-	if (!IsValid(World) || !World->IsGameWorld())
+	if (CurrentInactivityReason == EGameInactivityReason::Preparation && GetPreparationTimerDuration() > 0.0f)
 	{
-		return false;
+		StartPreparationTimer();
 	}
+}
 
-	FTimerManager& TimerManager = World->GetTimerManager();
-
-	if (!TimerManager.IsTimerActive(PreparationTimerHandle))
+float ATrickyGameModeBase::GetPreparationTimerDuration() const
+{
+	if (IsBetweenRounds())
 	{
-		return false;
+		return RoundPreparationDuration;
 	}
 
-	const float ElapsedTime = TimerManager.GetTimerElapsed(PreparationTimerHandle);
-	TimerManager.ClearTimer(PreparationTimerHandle);
-	OnPreparationTimerStopped.Broadcast(ElapsedTime);
+	return bIsReadyCheckEnabled ? ReadyCheckTimeout : PreparationDuration;
+}
+
+void ATrickyGameModeBase::TryCompleteReadyCheck()
+{
+	const bool bIsPreparing = CurrentState == ETrickyGameState::Inactive
+		&& CurrentInactivityReason == EGameInactivityReason::Preparation;
+
+	if (!bIsReadyCheckEnabled || !bIsPreparing || IsBetweenRounds() || !ReadyCheck.HasQuorum(ReadyCheckQuorum))
+	{
+		return;
+	}
 
 #if WITH_EDITOR || !UE_BUILD_SHIPPING
-	const FString LogMessage = FString::Printf(TEXT("Preparation Timer stopped. Elapsed time: %.2f"), ElapsedTime);
-	PrintLog(LogMessage);
+	UE_LOG(LogTrickyGameMode,
+	       Display,
+	       TEXT("Ready check completed. Ready players: %d/%d"),
+	       ReadyCheck.ReadyNum,
+	       ReadyCheck.ConnectedNum);
 #endif
 
-	return true;
+	SelfCaller.StartGame();
 }
 
-bool ATrickyGameModeBase::PausePreparationTimer()
+EGameResult ATrickyGameModeBase::CalculateMatchResult_Implementation()
 {
-	const UWorld* World = GetWorld();
+	const int32 WinsNum = GetRoundsNumWithResult(EGameResult::Win);
+	const int32 LossesNum = GetRoundsNumWithResult(EGameResult::Loose);
 
-	if (!IsValid(World) || !World->IsGameWorld())
+	if (WinsNum == LossesNum)
 	{
-		return false;
+		return EGameResult::Draw;
 	}
 
-	FTimerManager& TimerManager = World->GetTimerManager();
+	return WinsNum > LossesNum ? EGameResult::Win : EGameResult::Loose;
+}
+
+bool ATrickyGameModeBase::IsMatchDecided_Implementation()
+{
+	const int32 RequiredWinsNum = RoundsNum / 2 + 1;
 
-	if (!TimerManager.IsTimerActive(PreparationTimerHandle))
+	return RoundResults.Num() >= RoundsNum
+		|| GetRoundsNumWithResult(EGameResult::Win) >= RequiredWinsNum
+		|| GetRoundsNumWithResult(EGameResult::Loose) >= RequiredWinsNum;
+}
+
+void ATrickyGameModeBase::UpdateReplicatedRound() const
+{
+	ATrickyGameStateBase* TrickyGameState = GetGameState<ATrickyGameStateBase>();
+
+	if (!IsValid(TrickyGameState))
 	{
-		return false;
+		return;
 	}
 
-	TimerManager.PauseTimer(PreparationTimerHandle);
+	TrickyGameState->SetCurrentRound(CurrentRound);
+}
 
-#if WITH_EDITOR || !UE_BUILD_SHIPPING
-	const float ElapsedTime = TimerManager.GetTimerElapsed(PreparationTimerHandle);
-	const FString LogMessage = FString::Printf(TEXT("Preparation Timer paused. Elapsed Time: %.2f"), ElapsedTime);
-	PrintLog(LogMessage);
-#endif
+void ATrickyGameModeBase::UpdateReplicatedReadyCheck() const
+{
+	ATrickyGameStateBase* TrickyGameState = GetGameState<ATrickyGameStateBase>();
 
-	return true;
+	if (!IsValid(TrickyGameState))
+	{
+		return;
+	}
+
+	TrickyGameState->SetReadyCheck(ReadyCheck);
 }
 
-bool ATrickyGameModeBase::UnPausePreparationTimer()
+void ATrickyGameModeBase::FinishPlayersInSlots(const TArray<int32>& Slots, const EGameResult Result)
 {
-	const UWorld* World = GetWorld();
+	for (const int32 Slot : Slots)
+	{
+		const int32 Team = Participants.GetPlayerTeam(Slot);
 
-	if (!IsValid(World) || !World->IsGameWorld())
+		if (!Participants.FinishPlayer(Slot, Result))
+		{
+			continue;
+		}
+
+		TRICKY_GAME_MODE_BROADCAST(OnPlayerFinished, SlotPlayers[Slot], Result);
+
+		if (Participants.GetTeamState(Team) == ETrickyGameState::Finished)
+		{
+			TRICKY_GAME_MODE_BROADCAST(OnTeamFinished, Team, Participants.GetTeamResult(Team));
+		}
+	}
+}
+
+void ATrickyGameModeBase::TryAutoFinishGame()
+{
+	if (CurrentState != ETrickyGameState::Active)
 	{
-		return false;
+		return;
 	}
 
-	FTimerManager& TimerManager = World->GetTimerManager();
+	bool bIsConditionMet = false;
 
-	if (TimerManager.IsTimerActive(PreparationTimerHandle))
+	switch (AutoFinishCondition)
 	{
-		return false;
+	case ETrickyAutoFinishCondition::None:
+		break;
+
+	case ETrickyAutoFinishCondition::LastPlayerStanding:
+		bIsConditionMet = Participants.GetAliveNum() <= 1;
+		break;
+
+	case ETrickyAutoFinishCondition::LastTeamStanding:
+		bIsConditionMet = Participants.GetTeamsRemainingNum() <= 1;
+		break;
+
+	case ETrickyAutoFinishCondition::AllPlayersFinished:
+		bIsConditionMet = Participants.GetAliveNum() == 0;
+		break;
 	}
 
-	TimerManager.UnPauseTimer(PreparationTimerHandle);
+	if (!bIsConditionMet)
+	{
+		return;
+	}
 
-#if WITH_EDITOR || !UE_BUILD_SHIPPING
-	const float ElapsedTime = TimerManager.GetTimerRemaining(PreparationTimerHandle);
-	const FString LogMessage = FString::Printf(TEXT("Preparation Timer un-paused. Elapsed time: %.2f"), ElapsedTime);
-	PrintLog(LogMessage);
-#endif
+	// The condition is met once per game, so collecting the last standing players doesn't happen every frame.
+	TArray<int32> WinnerSlots;
 
-	return true;
+	for (int32 Slot = 0; Slot < Participants.GetSlotsNum() && WinnerSlots.Num() < Participants.GetAliveNum(); ++Slot)
+	{
+		if (Participants.IsPlayerAlive(Slot))
+		{
+			WinnerSlots.Add(Slot);
+		}
+	}
+
+	FinishPlayersInSlots(WinnerSlots, EGameResult::Win);
+
+	if (bIsRoundBased)
+	{
+		FinishRound(CalculateAutoFinishResult());
+		return;
+	}
+
+	SelfCaller.FinishGame(CalculateAutoFinishResult());
 }
 
-bool ATrickyGameModeBase::StartGameTimer()
+bool ATrickyGameModeBase::StopPreparationTimer()
 {
 	const UWorld* World = GetWorld();
 
-	if (!IsValid(World) || !World->IsGameWorld())
+	if (!IsValid(World)
+		|| !World->IsGameWorld()
+		|| !SessionClock.PreparationTimer.IsActive()
+		|| SessionClock.PreparationTimer.IsPaused())
 	{
 		return false;
 	}
 
-	FTimerManager& TimerManager = World->GetTimerManager();
+	const float ElapsedTime = static_cast<float>(SessionClock.GetPreparationElapsed(World->GetTimeSeconds()));
+	World->GetTimerManager().ClearTimer(PreparationTimerHandle);
+	SessionClock.PreparationTimer.Stop();
+	UpdateReplicatedTimers();
+	TRACE_TRICKY_GAME_MODE_TIMER(this, Preparation, Stop, World->GetTimeSeconds(), ElapsedTime);
+	TRICKY_GAME_MODE_BROADCAST(OnPreparationTimerStopped, ElapsedTime);
+	TRICKY_GAME_MODE_BROADCAST(OnPreparationTimerStoppedNative, ElapsedTime);
+
+#if WITH_EDITOR || !UE_BUILD_SHIPPING
+	UE_LOG(LogTrickyGameMode, Display, TEXT("Preparation Timer stopped. Elapsed time: %.2f"), ElapsedTime);
+#endif
+
+	return true;
+}
+
+bool ATrickyGameModeBase::PausePreparationTimer()
+{
+	const UWorld* World = GetWorld();
 
-	if (TimerManager.IsTimerActive(GameTimerHandle))
+	if (!IsValid(World) || !World->IsGameWorld() || !SessionClock.PreparationTimer.Pause(World->GetTimeSeconds()))
 	{
 		return false;
 	}
 
-	TimerManager.SetTimer(GameTimerHandle, this, &ATrickyGameModeBase::HandleGameTimerFinished, GameDuration, false);
-	OnGameTimerStarted.Broadcast(GameDuration);
+	World->GetTimerManager().PauseTimer(PreparationTimerHandle);
+	UpdateReplicatedTimers();
+	TRACE_TRICKY_GAME_MODE_TIMER(this,
+	                             Preparation,
+	                             Pause,
+	                             World->GetTimeSeconds(),
+	                             SessionClock.PreparationTimer.Duration);
 
 #if WITH_EDITOR || !UE_BUILD_SHIPPING
-	const FString LogMessage = FString::Printf(TEXT("Game Timer started. Duration: %.2f"), GameDuration);
-	PrintLog(LogMessage);
+	UE_LOG(LogTrickyGameMode,
+	       Display,
+	       TEXT("Preparation Timer paused. Elapsed Time: %.2f"),
+	       SessionClock.GetPreparationElapsed(World->GetTimeSeconds()));
 #endif
 
 	return true;
 }
 
-bool ATrickyGameModeBase::StopGameTimer()
+bool ATrickyGameModeBase::UnPausePreparationTimer()
 {
 	const UWorld* World = GetWorld();
 
-	if (!IsValid(World) || !World->IsGameWorld())
+	if (!IsValid(World) || !World->IsGameWorld() || !SessionClock.PreparationTimer.UnPause(World->GetTimeSeconds()))
 	{
 		return false;
 	}
 
-	FTimerManager& TimerManager = World->GetTimerManager();
+	World->GetTimerManager().UnPauseTimer(PreparationTimerHandle);
+	UpdateReplicatedTimers();
+	TRACE_TRICKY_GAME_MODE_TIMER(this,
+	                             Preparation,
+	                             UnPause,
+	                             World->GetTimeSeconds(),
+	                             SessionClock.PreparationTimer.Duration);
+
+#if WITH_EDITOR || !UE_BUILD_SHIPPING
+	UE_LOG(LogTrickyGameMode,
+	       Display,
+	       TEXT("Preparation Timer un-paused. Elapsed time: %.2f"),
+	       SessionClock.GetPreparationElapsed(World->GetTimeSeconds()));
+#endif
+
+	return true;
+}
+
+bool ATrickyGameModeBase::StartGameTimer()
+{
+	const UWorld* World = GetWorld();
 
-	if (!TimerManager.IsTimerActive(GameTimerHandle))
+	if (!IsValid(World) || !World->IsGameWorld() || SessionClock.GameTimer.IsActive())
 	{
 		return false;
 	}
 
-	const float ElapsedTime = TimerManager.GetTimerElapsed(GameTimerHandle);
-	OnGameTimerStopped.Broadcast(ElapsedTime);
-	TimerManager.ClearTimer(GameTimerHandle);
+	World->GetTimerManager().SetTimer(GameTimerHandle,
+	                                  this,
+	                                  &ATrickyGameModeBase::HandleGameTimerFinished,
+	                                  GameDuration,
+	                                  false);
+	SessionClock.GameTimer.Start(World->GetTimeSeconds(), GameDuration);
+	UpdateReplicatedTimers();
+	TRACE_TRICKY_GAME_MODE_TIMER(this, Game, Start, World->GetTimeSeconds(), GameDuration);
+	TRICKY_GAME_MODE_BROADCAST(OnGameTimerStarted, GameDuration);
+	TRICKY_GAME_MODE_BROADCAST(OnGameTimerStartedNative, GameDuration);
 
 #if WITH_EDITOR || !UE_BUILD_SHIPPING
-	const FString LogMessage = FString::Printf(TEXT("Game Timer stopped. Elapsed time: %.2f"), ElapsedTime);
-	PrintLog(LogMessage);
+	UE_LOG(LogTrickyGameMode, Display, TEXT("Game Timer started. Duration: %.2f"), GameDuration);
 #endif
 
 	return true;
 }
 
-bool ATrickyGameModeBase::PauseGameTimer() const
+bool ATrickyGameModeBase::StopGameTimer()
 {
 	const UWorld* World = GetWorld();
 
-	if (!IsValid(World) || !World->IsGameWorld())
+	if (!IsValid(World)
+		|| !World->IsGameWorld()
+		|| !SessionClock.GameTimer.IsActive()
+		|| SessionClock.GameTimer.IsPaused())
 	{
 		return false;
 	}
 
-	FTimerManager& TimerManager = World->GetTimerManager();
+	const float ElapsedTime = static_cast<float>(SessionClock.GetGameElapsed(World->GetTimeSeconds()));
+	const bool bIsTimeLimited = SessionClock.GameTimer.IsLimited();
 
-	if (!TimerManager.IsTimerActive(GameTimerHandle))
+	if (bIsTimeLimited)
 	{
-		return false;
+		TRICKY_GAME_MODE_BROADCAST(OnGameTimerStopped, ElapsedTime);
+		TRICKY_GAME_MODE_BROADCAST(OnGameTimerStoppedNative, ElapsedTime);
 	}
 
-	TimerManager.PauseTimer(GameTimerHandle);
+	World->GetTimerManager().ClearTimer(GameTimerHandle);
+	SessionClock.GameTimer.Stop();
+	UpdateReplicatedTimers();
+	TRACE_TRICKY_GAME_MODE_TIMER(this, Game, Stop, World->GetTimeSeconds(), ElapsedTime);
 
 #if WITH_EDITOR || !UE_BUILD_SHIPPING
-	const float ElapsedTime = TimerManager.GetTimerElapsed(GameTimerHandle);
-	const FString LogMessage = FString::Printf(TEXT("Game Timer paused. Elapsed Time: %.2f"), ElapsedTime);
-	PrintLog(LogMessage);
+	UE_LOG(LogTrickyGameMode, Display, TEXT("Game Timer stopped. Elapsed time: %.2f"), ElapsedTime);
 #endif
 
 	return true;
 }
 
-bool ATrickyGameModeBase::UnPauseGameTimer() const
+bool ATrickyGameModeBase::PauseGameTimer()
 {
 	const UWorld* World = GetWorld();
 
-	if (!IsValid(World) || !World->IsGameWorld())
+	if (!IsValid(World) || !World->IsGameWorld() || !SessionClock.GameTimer.Pause(World->GetTimeSeconds()))
 	{
 		return false;
 	}
 
-	FTimerManager& TimerManager = World->GetTimerManager();
+	World->GetTimerManager().PauseTimer(GameTimerHandle);
+	UpdateReplicatedTimers();
+	TRACE_TRICKY_GAME_MODE_TIMER(this, Game, Pause, World->GetTimeSeconds(), SessionClock.GameTimer.Duration);
+
+#if WITH_EDITOR || !UE_BUILD_SHIPPING
+	UE_LOG(LogTrickyGameMode,
+	       Display,
+	       TEXT("Game Timer paused. Elapsed Time: %.2f"),
+	       SessionClock.GetGameElapsed(World->GetTimeSeconds()));
+#endif
+
+	return true;
+}
+
+bool ATrickyGameModeBase::UnPauseGameTimer()
+{
+	const UWorld* World = GetWorld();
 
-	if (!TimerManager.IsTimerActive(GameTimerHandle))
+	if (!IsValid(World) || !World->IsGameWorld() || !SessionClock.GameTimer.UnPause(World->GetTimeSeconds()))
 	{
 		return false;
 	}
 
-	TimerManager.UnPauseTimer(GameTimerHandle);
+	World->GetTimerManager().UnPauseTimer(GameTimerHandle);
+	UpdateReplicatedTimers();
+	TRACE_TRICKY_GAME_MODE_TIMER(this, Game, UnPause, World->GetTimeSeconds(), SessionClock.GameTimer.Duration);
 
 #if WITH_EDITOR || !UE_BUILD_SHIPPING
-	const float ElapsedTime = TimerManager.GetTimerElapsed(GameTimerHandle);
-	const FString LogMessage = FString::Printf(TEXT("Game Timer unpaused. Elapsed Time: %.2f"), ElapsedTime);
-	PrintLog(LogMessage);
+	UE_LOG(LogTrickyGameMode,
+	       Display,
+	       TEXT("Game Timer unpaused. Elapsed Time: %.2f"),
+	       SessionClock.GetGameElapsed(World->GetTimeSeconds()));
 #endif
 
 	return true;
@@ -497,46 +1166,306 @@ bool ATrickyGameModeBase::UnPauseGameTimer() const
 
 void ATrickyGameModeBase::HandleGameTimerFinished()
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(ATrickyGameModeBase::HandleGameTimerFinished);
+
+	TRACE_TRICKY_GAME_MODE_TIMER(this, Game, Finish, GetWorld()->GetTimeSeconds(), SessionClock.GameTimer.Duration);
+	GameTimerHandle.Invalidate();
+	SessionClock.GameTimer.Stop();
+	UpdateReplicatedTimers();
 	DefaultTimeOverResult = CalculateTimeOverResult();
-	Execute_FinishGame(this, DefaultTimeOverResult);
+
+	if (bIsRoundBased)
+	{
+		FinishRound(DefaultTimeOverResult);
+		return;
+	}
+
+	SelfCaller.FinishGame(DefaultTimeOverResult);
 }
 
 bool ATrickyGameModeBase::ChangeGameState(const ETrickyGameState NewState)
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(ATrickyGameModeBase::ChangeGameState);
+
 	if (CurrentState == NewState)
 	{
 		return false;
 	}
 
+	FTrickyTransitionScope TransitionScope(this);
 	LastState = CurrentState;
 	CurrentState = NewState;
-	OnGameStateChanged.Broadcast(CurrentState);
+	SessionClock.StartPhase(GetWorld()->GetTimeSeconds());
+	UpdateReplicatedState();
+	TRICKY_GAME_MODE_BROADCAST(OnGameStateChanged, CurrentState);
 	return true;
 }
 
-#if WITH_EDITOR || !UE_BUILD_SHIPPING
-void ATrickyGameModeBase::PrintWarning(const FString& Message) const
+void ATrickyGameModeBase::UpdateReplicatedState() const
 {
-	UE_LOG(LogTrickyGameMode, Warning, TEXT("%s"), *Message);
+	ATrickyGameStateBase* TrickyGameState = GetGameState<ATrickyGameStateBase>();
+
+	if (!IsValid(TrickyGameState))
+	{
+		return;
+	}
+
+	FTrickyReplicatedGameState NewState;
+	NewState.State = CurrentState;
+	NewState.LastState = LastState;
+	NewState.InactivityReason = CurrentInactivityReason;
+	NewState.Result = GameResult;
+	TrickyGameState->SetReplicatedState(NewState);
 }
 
-void ATrickyGameModeBase::PrintLog(const FString& Message) const
+void ATrickyGameModeBase::BeginTransition()
 {
-	UE_LOG(LogTrickyGameMode, Display, TEXT("%s"), *Message);
+	if (TransitionDepth++ > 0)
+	{
+		return;
+	}
+
+	PendingTransition.FromState = CurrentState;
+	PendingTransition.FromReason = CurrentInactivityReason;
 }
 
-void ATrickyGameModeBase::GetGameStateName(FString& StateName, const ETrickyGameState State)
+void ATrickyGameModeBase::EndTransition()
 {
-	StateName = StaticEnum<ETrickyGameState>()->GetNameStringByValue(static_cast<int64>(State));
+	if (--TransitionDepth > 0)
+	{
+		return;
+	}
+
+	PublishStateSnapshot();
+
+	const FTrickyGameStateTransition Transition = MakeTransition();
+	const bool bHasStateChanged = Transition.FromState != Transition.ToState;
+	const bool bHasReasonChanged = Transition.FromReason != Transition.ToReason;
+
+	if (!bHasStateChanged && !bHasReasonChanged)
+	{
+		BroadcastPendingNativeEvents(Transition);
+		return;
+	}
+
+	LastTransition = Transition;
+	TRACE_TRICKY_GAME_MODE_TRANSITION(this, Transition);
+
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(ATrickyGameModeBase::ApplyTickPolicies);
+		TickPolicies.Apply(CurrentState, CurrentInactivityReason);
+	}
+
+	UpdateServerTickRate();
+
+	if (bHasStateChanged)
+	{
+		TRICKY_GAME_MODE_BROADCAST(OnGameStateChangedNative, Transition);
+	}
+
+	if (bHasReasonChanged)
+	{
+		TRICKY_GAME_MODE_BROADCAST(OnInactivityReasonChangedNative, Transition);
+	}
+
+	BroadcastPendingNativeEvents(Transition);
+	TransitionDispatcher.Dispatch(Transition);
+
+	if (TransitionDispatcher.HasDeferredListeners())
+	{
+		SetActorTickEnabled(true);
+	}
 }
 
-void ATrickyGameModeBase::GetInactivityReasonName(FString& ReasonName, const EGameInactivityReason Reason)
+void ATrickyGameModeBase::BroadcastPendingNativeEvents(const FTrickyGameStateTransition& Transition)
 {
-	ReasonName = StaticEnum<EGameInactivityReason>()->GetNameStringByValue(static_cast<int64>(Reason));
+	// Listeners may start a new transition which queues its own events.
+	const TArray<ETrickyNativeTransitionEvent, TInlineAllocator<4>> Events = MoveTemp(PendingNativeEvents);
+	PendingNativeEvents.Reset();
+
+	for (const ETrickyNativeTransitionEvent Event : Events)
+	{
+		switch (Event)
+		{
+		case ETrickyNativeTransitionEvent::GameStarted:
+			TRICKY_GAME_MODE_BROADCAST(OnGameStartedNative, Transition);
+			break;
+
+		case ETrickyNativeTransitionEvent::GameFinished:
+			TRICKY_GAME_MODE_BROADCAST(OnGameFinishedNative, Transition);
+			break;
+
+		case ETrickyNativeTransitionEvent::GameStopped:
+			TRICKY_GAME_MODE_BROADCAST(OnGameStoppedNative, Transition);
+			break;
+
+		case ETrickyNativeTransitionEvent::RematchStarted:
+			TRICKY_GAME_MODE_BROADCAST(OnRematchStartedNative, Transition);
+			break;
+		}
+	}
 }
 
-void ATrickyGameModeBase::GetGameResultName(FString& ResultName, const EGameResult Result)
+FTrickyGameStateTransition ATrickyGameModeBase::MakeTransition() const
 {
-	ResultName = StaticEnum<EGameResult>()->GetNameStringByValue(static_cast<int64>(Result));
+	FTrickyGameStateTransition Transition = PendingTransition;
+	Transition.ToState = CurrentState;
+	Transition.ToReason = CurrentInactivityReason;
+	Transition.Result = GameResult;
+	Transition.Timestamp = GetWorld()->GetTimeSeconds();
+	return Transition;
 }
+
+void ATrickyGameModeBase::UpdateReplicatedTimers()
+{
+	// Transitions publish the snapshot when they end.
+	if (TransitionDepth == 0)
+	{
+		PublishStateSnapshot();
+	}
+
+	ATrickyGameStateBase* TrickyGameState = GetGameState<ATrickyGameStateBase>();
+
+	if (!IsValid(TrickyGameState))
+	{
+		return;
+	}
+
+	TrickyGameState->SetPreparationTimer(SessionClock.PreparationTimer);
+	TrickyGameState->SetGameTimer(SessionClock.GameTimer);
+}
+
+void ATrickyGameModeBase::PublishStateSnapshot()
+{
+	FTrickyGameStateSnapshot Snapshot;
+	Snapshot.State = CurrentState;
+	Snapshot.LastState = LastState;
+	Snapshot.InactivityReason = CurrentInactivityReason;
+	Snapshot.Result = GameResult;
+	Snapshot.Clock = SessionClock;
+	Snapshot.PublishWorldTime = GetWorld()->GetTimeSeconds();
+	Snapshot.PublishPlatformTime = FPlatformTime::Seconds();
+	StateSnapshotPublisher->Publish(Snapshot);
+}
+
+UE::Tasks::TTask<bool> ATrickyGameModeBase::WaitForMilestone(const FTrickyTimerMilestone& Milestone,
+                                                             const bool bIsPreparation)
+{
+	const FTrickyTaskWaitList::FWaitRef Wait = TaskWaits.Add();
+	ATrickyGameStateBase* TrickyGameState = GetGameState<ATrickyGameStateBase>();
+
+	if (!IsValid(TrickyGameState))
+	{
+		TaskWaits.Complete(Wait, false);
+		return FTrickyTaskWaitList::MakeTask(Wait);
+	}
+
+	FOnTimerMilestoneSignature::FDelegate Delegate = FOnTimerMilestoneSignature::FDelegate::CreateWeakLambda(
+		this,
+		[this, Wait](const FTrickyTimerMilestone& ReachedMilestone)
+		{
+			TaskWaits.Complete(Wait, true);
+		});
+	const FDelegateHandle Handle = bIsPreparation
+		                               ? TrickyGameState->AddPreparationMilestone(Milestone, MoveTemp(Delegate))
+		                               : TrickyGameState->AddGameMilestone(Milestone, MoveTemp(Delegate));
+	TWeakObjectPtr<ATrickyGameStateBase> WeakGameState = TrickyGameState;
+	Wait->Unsubscribe = [WeakGameState, Handle, bIsPreparation]()
+	{
+		ATrickyGameStateBase* GameStateToClean = WeakGameState.Get();
+
+		if (!GameStateToClean)
+		{
+			return;
+		}
+
+		if (bIsPreparation)
+		{
+			GameStateToClean->RemovePreparationMilestone(Handle);
+		}
+		else
+		{
+			GameStateToClean->RemoveGameMilestone(Handle);
+		}
+	};
+	return FTrickyTaskWaitList::MakeTask(Wait);
+}
+
+void ATrickyGameModeBase::UpdateServerTickRate(const AController* ExitingPlayer)
+{
+	UWorld* World = GetWorld();
+	UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+
+	if (!NetDriver || GetNetMode() != NM_DedicatedServer)
+	{
+		return;
+	}
+
+	if (DefaultServerTickRate <= 0)
+	{
+		DefaultServerTickRate = NetDriver->GetNetServerMaxTickRate();
+	}
+
+	// The exiting player still has a player state, so it's counted until the controller is destroyed.
+	int32 PlayersNum = GetNumPlayers() + GetNumSpectators();
+
+	if (ExitingPlayer && ExitingPlayer->IsPlayerController() && ExitingPlayer->PlayerState)
+	{
+		--PlayersNum;
+	}
+
+	// A connection without a player controller is a login in progress, so the server wakes up before PreLogin.
+	const bool bIsLoginPending = NetDriver->ClientConnections.ContainsByPredicate([](const UNetConnection* Connection)
+	{
+		return Connection && !Connection->PlayerController;
+	});
+
+	const bool bHasPlayers = PlayersNum > 0 || bIsLoginPending;
+
+	if (bHasPlayers || ServerTickRates.Hibernation <= 0)
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(HibernationTickerHandle);
+		HibernationTickerHandle.Reset();
+	}
+	else if (!HibernationTickerHandle.IsValid())
+	{
+		HibernationTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateUObject(this, &ATrickyGameModeBase::HandleHibernationTick));
+	}
+
+	const int32 TickRate = ServerTickRates.GetTickRate(CurrentState, CurrentInactivityReason, bHasPlayers);
+	const int32 TargetTickRate = TickRate > 0 ? TickRate : DefaultServerTickRate;
+
+	if (NetDriver->GetNetServerMaxTickRate() == TargetTickRate)
+	{
+		return;
+	}
+
+#if WITH_EDITOR || !UE_BUILD_SHIPPING
+	UE_LOG(LogTrickyGameMode, Display, TEXT("Server Tick Rate Changed to %d"), TargetTickRate);
 #endif
+
+	NetDriver->SetNetServerMaxTickRate(TargetTickRate);
+}
+
+bool ATrickyGameModeBase::HandleHibernationTick(float DeltaTime)
+{
+	UpdateServerTickRate();
+	return true;
+}
+
+void ATrickyGameModeBase::RestoreServerTickRate()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(HibernationTickerHandle);
+	HibernationTickerHandle.Reset();
+
+	UWorld* World = GetWorld();
+	UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+
+	if (NetDriver && DefaultServerTickRate > 0)
+	{
+		NetDriver->SetNetServerMaxTickRate(DefaultServerTickRate);
+	}
+
+	DefaultServerTickRate = 0;
+}
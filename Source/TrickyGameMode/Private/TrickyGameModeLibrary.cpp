@@ -4,167 +4,431 @@
 #include "TrickyGameModeLibrary.h"
 
 #include "TrickyGameModeBase.h"
-#include "Kismet/GameplayStatics.h"
+#include "TrickyGameModeSubsystem.h"
+#include "TrickyGameStateBase.h"
+#include "TrickySessionManagerSubsystem.h"
+#include "Engine/Engine.h"
 #include "Engine/World.h"
-#include "TimerManager.h"
 
 ATrickyGameModeBase* UTrickyGameModeLibrary::GetTrickyGameMode(const UObject* WorldContextObject)
 {
-	return Cast<ATrickyGameModeBase>(UGameplayStatics::GetGameMode(WorldContextObject));
+	return Cast<ATrickyGameModeBase>(GetGameStateController(WorldContextObject));
+}
+
+ATrickyGameStateBase* UTrickyGameModeLibrary::GetTrickyGameState(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? World->GetGameState<ATrickyGameStateBase>() : nullptr;
+}
+
+UTrickyCountdownViewModel* UTrickyGameModeLibrary::GetCountdownViewModel(const UObject* WorldContextObject)
+{
+	const ATrickyGameStateBase* GameState = GetTrickyGameState(WorldContextObject);
+	return IsValid(GameState) ? GameState->GetCountdownViewModel() : nullptr;
 }
 
 bool UTrickyGameModeLibrary::StartGame(const UObject* WorldContextObject)
 {
-	if (!ImplementsGameStateInterface(WorldContextObject))
+	const FGameStateControllerCaller* Caller = GetGameStateControllerCaller(WorldContextObject);
+
+	if (!Caller)
 	{
 		return false;
 	}
 
-	return IGameStateControllerInterface::Execute_StartGame(UGameplayStatics::GetGameMode(WorldContextObject));
+	return Caller->StartGame();
 }
 
 bool UTrickyGameModeLibrary::StopGame(const UObject* WorldContextObject, const EGameInactivityReason Reason)
 {
-	if (!ImplementsGameStateInterface(WorldContextObject))
+	const FGameStateControllerCaller* Caller = GetGameStateControllerCaller(WorldContextObject);
+
+	if (!Caller)
 	{
 		return false;
 	}
 
-	return IGameStateControllerInterface::Execute_StopGame(UGameplayStatics::GetGameMode(WorldContextObject), Reason);
+	return Caller->StopGame(Reason);
 }
 
 bool UTrickyGameModeLibrary::FinishGame(const UObject* WorldContextObject, const EGameResult Result)
 {
-	if (!ImplementsGameStateInterface(WorldContextObject))
+	const FGameStateControllerCaller* Caller = GetGameStateControllerCaller(WorldContextObject);
+
+	if (!Caller)
 	{
 		return false;
 	}
 
-	return IGameStateControllerInterface::Execute_FinishGame(UGameplayStatics::GetGameMode(WorldContextObject), Result);
+	return Caller->FinishGame(Result);
 }
 
 bool UTrickyGameModeLibrary::ChangeInactivityReason(const UObject* WorldContextObject, EGameInactivityReason Reason)
 {
-	if (!ImplementsGameStateInterface(WorldContextObject))
+	const FGameStateControllerCaller* Caller = GetGameStateControllerCaller(WorldContextObject);
+
+	if (!Caller)
 	{
 		return false;
 	}
 
-	return IGameStateControllerInterface::Execute_ChangeInactivityReason(
-		UGameplayStatics::GetGameMode(WorldContextObject), Reason);
+	return Caller->ChangeInactivityReason(Reason);
 }
 
 bool UTrickyGameModeLibrary::StartPreparation(const UObject* WorldContextObject)
 {
-	if (!ImplementsGameStateInterface(WorldContextObject))
+	const FGameStateControllerCaller* Caller = GetGameStateControllerCaller(WorldContextObject);
+
+	if (!Caller)
 	{
 		return false;
 	}
 
-	return IGameStateControllerInterface::Execute_StartPreparation(UGameplayStatics::GetGameMode(WorldContextObject));
+	return Caller->StartPreparation();
 }
 
 bool UTrickyGameModeLibrary::StartCutscene(const UObject* WorldContextObject)
 {
-	if (!ImplementsGameStateInterface(WorldContextObject))
+	const FGameStateControllerCaller* Caller = GetGameStateControllerCaller(WorldContextObject);
+
+	if (!Caller)
 	{
 		return false;
 	}
 
-	return IGameStateControllerInterface::Execute_StartCutscene(UGameplayStatics::GetGameMode(WorldContextObject));
+	return Caller->StartCutscene();
 }
 
 bool UTrickyGameModeLibrary::StartTransition(const UObject* WorldContextObject)
 {
-	if (!ImplementsGameStateInterface(WorldContextObject))
+	const FGameStateControllerCaller* Caller = GetGameStateControllerCaller(WorldContextObject);
+
+	if (!Caller)
 	{
 		return false;
 	}
 
-	return IGameStateControllerInterface::Execute_StartTransition(UGameplayStatics::GetGameMode(WorldContextObject));
+	return Caller->StartTransition();
 }
 
 ETrickyGameState UTrickyGameModeLibrary::GetGameState(const UObject* WorldContextObject)
 {
-	if (!ImplementsGameStateInterface(WorldContextObject))
+	const FGameStateControllerCaller* Caller = GetGameStateControllerCaller(WorldContextObject);
+
+	if (!Caller)
 	{
 		return ETrickyGameState::Inactive;
 	}
 
-	return IGameStateControllerInterface::Execute_GetGameState(UGameplayStatics::GetGameMode(WorldContextObject));
+	return Caller->GetGameState();
 }
 
 EGameResult UTrickyGameModeLibrary::GetGameResult(const UObject* WorldContextObject)
 {
-	if (!ImplementsGameStateInterface(WorldContextObject))
+	const FGameStateControllerCaller* Caller = GetGameStateControllerCaller(WorldContextObject);
+
+	if (!Caller)
 	{
 		return EGameResult::None;
 	}
 
-	return IGameStateControllerInterface::Execute_GetGameResult(UGameplayStatics::GetGameMode(WorldContextObject));
+	return Caller->GetGameResult();
 }
 
 EGameInactivityReason UTrickyGameModeLibrary::GetInactivityReason(const UObject* WorldContextObject)
 {
-	if (!ImplementsGameStateInterface(WorldContextObject))
+	const FGameStateControllerCaller* Caller = GetGameStateControllerCaller(WorldContextObject);
+
+	if (!Caller)
 	{
 		return EGameInactivityReason::None;
 	}
 
-	return IGameStateControllerInterface::Execute_GetGameInactivityReason(
-		UGameplayStatics::GetGameMode(WorldContextObject));
+	return Caller->GetGameInactivityReason();
 }
 
 float UTrickyGameModeLibrary::GetGameElapsedTime(const UObject* WorldContextObject)
 {
-	if (!ImplementsGameStateInterface(WorldContextObject))
+	const FGameStateControllerCaller* Caller = GetGameStateControllerCaller(WorldContextObject);
+
+	if (!Caller)
 	{
 		return -1.f;
 	}
 
-	return IGameStateControllerInterface::Execute_GetGameElapsedTime(UGameplayStatics::GetGameMode(WorldContextObject));
+	return Caller->GetGameElapsedTime();
 }
 
 float UTrickyGameModeLibrary::GetGameRemainingTime(const UObject* WorldContextObject)
 {
-	if (!ImplementsGameStateInterface(WorldContextObject))
+	const FGameStateControllerCaller* Caller = GetGameStateControllerCaller(WorldContextObject);
+
+	if (!Caller)
 	{
 		return -1.f;
 	}
 
-	return IGameStateControllerInterface::Execute_GetGameRemainingTime(
-		UGameplayStatics::GetGameMode(WorldContextObject));
+	return Caller->GetGameRemainingTime();
 }
 
 float UTrickyGameModeLibrary::GetGamePreparationRemainingTime(const UObject* WorldContextObject)
 {
-	const ATrickyGameModeBase* GameMode = GetTrickyGameMode(WorldContextObject);
-	const UWorld* World = GameMode->GetWorld();
+	const ATrickyGameStateBase* GameState = GetTrickyGameState(WorldContextObject);
 
-	if (!IsValid(GameMode) || !IsValid(World))
+	if (!IsValid(GameState))
 	{
 		return -1.f;
 	}
 
-	return World->GetTimerManager().GetTimerRemaining(GameMode->GetPreparationTimerHandle());
+	return GameState->GetPreparationRemainingTime();
 }
 
 float UTrickyGameModeLibrary::GetGamePreparationElapsedTime(const UObject* WorldContextObject)
 {
-	const ATrickyGameModeBase* GameMode = GetTrickyGameMode(WorldContextObject);
-	const UWorld* World = GameMode->GetWorld();
+	const ATrickyGameStateBase* GameState = GetTrickyGameState(WorldContextObject);
 
-	if (!IsValid(GameMode) || !IsValid(World))
+	if (!IsValid(GameState))
 	{
 		return -1.f;
 	}
 
-	return World->GetTimerManager().GetTimerElapsed(GameMode->GetPreparationTimerHandle());
+	return GameState->GetPreparationElapsedTime();
+}
+
+bool UTrickyGameModeLibrary::RegisterForRematch(AActor* Actor)
+{
+	UTrickyGameModeSubsystem* Subsystem = UTrickyGameModeSubsystem::Get(Actor);
+	return Subsystem && Subsystem->GetRematchRegistry().Register(Actor);
+}
+
+bool UTrickyGameModeLibrary::UnregisterFromRematch(AActor* Actor)
+{
+	UTrickyGameModeSubsystem* Subsystem = UTrickyGameModeSubsystem::Get(Actor);
+	return Subsystem && Subsystem->GetRematchRegistry().Unregister(Actor);
+}
+
+bool UTrickyGameModeLibrary::RegisterTickPolicy(UObject* Object, const FTrickyTickPolicy& Policy)
+{
+	ATrickyGameModeBase* GameMode = GetTrickyGameMode(Object);
+	return GameMode && GameMode->RegisterTickPolicy(Object, Policy);
+}
+
+bool UTrickyGameModeLibrary::UnregisterTickPolicy(UObject* Object)
+{
+	ATrickyGameModeBase* GameMode = GetTrickyGameMode(Object);
+	return GameMode && GameMode->UnregisterTickPolicy(Object);
+}
+
+FTrickySessionId UTrickyGameModeLibrary::CreateSession(const UObject* WorldContextObject,
+                                                       const FTrickySessionSettings& Settings)
+{
+	UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return FTrickySessionId();
+	}
+
+	return SessionManager->CreateSession(Settings);
+}
+
+bool UTrickyGameModeLibrary::DestroySession(const UObject* WorldContextObject, const FTrickySessionId& SessionId)
+{
+	UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return false;
+	}
+
+	return SessionManager->DestroySession(SessionId);
+}
+
+bool UTrickyGameModeLibrary::StartSessionGame(const UObject* WorldContextObject, const FTrickySessionId& SessionId)
+{
+	UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return false;
+	}
+
+	return SessionManager->StartGame(SessionId);
 }
 
-bool UTrickyGameModeLibrary::ImplementsGameStateInterface(const UObject* WorldContextObject)
+bool UTrickyGameModeLibrary::StopSessionGame(const UObject* WorldContextObject,
+                                             const FTrickySessionId& SessionId,
+                                             EGameInactivityReason Reason)
 {
-	const AGameModeBase* GameMode = UGameplayStatics::GetGameMode(WorldContextObject);
+	UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return false;
+	}
+
+	return SessionManager->StopGame(SessionId, Reason);
+}
+
+bool UTrickyGameModeLibrary::FinishSessionGame(const UObject* WorldContextObject,
+                                               const FTrickySessionId& SessionId,
+                                               EGameResult Result)
+{
+	UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return false;
+	}
+
+	return SessionManager->FinishGame(SessionId, Result);
+}
+
+bool UTrickyGameModeLibrary::ChangeSessionInactivityReason(const UObject* WorldContextObject,
+                                                           const FTrickySessionId& SessionId,
+                                                           EGameInactivityReason Reason)
+{
+	UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return false;
+	}
+
+	return SessionManager->ChangeInactivityReason(SessionId, Reason);
+}
+
+bool UTrickyGameModeLibrary::StartSessionPreparation(const UObject* WorldContextObject,
+                                                     const FTrickySessionId& SessionId)
+{
+	UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return false;
+	}
+
+	return SessionManager->StartPreparation(SessionId);
+}
+
+bool UTrickyGameModeLibrary::StartSessionCutscene(const UObject* WorldContextObject, const FTrickySessionId& SessionId)
+{
+	UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return false;
+	}
+
+	return SessionManager->StartCutscene(SessionId);
+}
+
+bool UTrickyGameModeLibrary::StartSessionTransition(const UObject* WorldContextObject,
+                                                    const FTrickySessionId& SessionId)
+{
+	UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return false;
+	}
+
+	return SessionManager->StartTransition(SessionId);
+}
+
+ETrickyGameState UTrickyGameModeLibrary::GetSessionGameState(const UObject* WorldContextObject,
+                                                             const FTrickySessionId& SessionId)
+{
+	const UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return ETrickyGameState::Inactive;
+	}
+
+	return SessionManager->GetGameState(SessionId);
+}
+
+EGameResult UTrickyGameModeLibrary::GetSessionGameResult(const UObject* WorldContextObject,
+                                                         const FTrickySessionId& SessionId)
+{
+	const UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return EGameResult::None;
+	}
+
+	return SessionManager->GetGameResult(SessionId);
+}
+
+EGameInactivityReason UTrickyGameModeLibrary::GetSessionInactivityReason(const UObject* WorldContextObject,
+                                                                         const FTrickySessionId& SessionId)
+{
+	const UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return EGameInactivityReason::None;
+	}
+
+	return SessionManager->GetGameInactivityReason(SessionId);
+}
+
+float UTrickyGameModeLibrary::GetSessionElapsedTime(const UObject* WorldContextObject,
+                                                    const FTrickySessionId& SessionId)
+{
+	const UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return -1.f;
+	}
+
+	return SessionManager->GetGameElapsedTime(SessionId);
+}
+
+float UTrickyGameModeLibrary::GetSessionRemainingTime(const UObject* WorldContextObject,
+                                                      const FTrickySessionId& SessionId)
+{
+	const UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return -1.f;
+	}
+
+	return SessionManager->GetGameRemainingTime(SessionId);
+}
+
+float UTrickyGameModeLibrary::GetSessionPreparationRemainingTime(const UObject* WorldContextObject,
+                                                                 const FTrickySessionId& SessionId)
+{
+	const UTrickySessionManagerSubsystem* SessionManager = UTrickySessionManagerSubsystem::Get(WorldContextObject);
+
+	if (!SessionManager)
+	{
+		return -1.f;
+	}
+
+	return SessionManager->GetPreparationRemainingTime(SessionId);
+}
+
+UObject* UTrickyGameModeLibrary::GetGameStateController(const UObject* WorldContextObject)
+{
+	const UTrickyGameModeSubsystem* Subsystem = UTrickyGameModeSubsystem::Get(WorldContextObject);
+	return Subsystem ? Subsystem->GetGameStateController() : nullptr;
+}
+
+const FGameStateControllerCaller* UTrickyGameModeLibrary::GetGameStateControllerCaller(
+	const UObject* WorldContextObject)
+{
+	const UTrickyGameModeSubsystem* Subsystem = UTrickyGameModeSubsystem::Get(WorldContextObject);
+
+	if (!Subsystem || !Subsystem->GetGameStateControllerCaller().IsValid())
+	{
+		return nullptr;
+	}
 
-	return GameMode->Implements<UGameStateControllerInterface>();
+	return &Subsystem->GetGameStateControllerCaller();
 }
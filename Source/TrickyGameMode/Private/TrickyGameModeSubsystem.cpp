@@ -0,0 +1,101 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyGameModeSubsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/GameStateBase.h"
+
+void UTrickyGameModeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	GameModeInitializedHandle = FGameModeEvents::GameModeInitializedEvent.AddUObject(
+		this, &UTrickyGameModeSubsystem::HandleGameModeInitialized);
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddUObject(
+		this, &UTrickyGameModeSubsystem::HandleWorldCleanup);
+}
+
+void UTrickyGameModeSubsystem::Deinitialize()
+{
+	FGameModeEvents::GameModeInitializedEvent.Remove(GameModeInitializedHandle);
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	GameStateController = nullptr;
+	ControllerCaller = FGameStateControllerCaller();
+	RematchRegistry.Reset();
+
+	Super::Deinitialize();
+}
+
+void UTrickyGameModeSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (GameStateController)
+	{
+		return;
+	}
+
+	// Clients don't have a game mode, the game state mirrors it there.
+	if (!SetGameStateController(InWorld.GetAuthGameMode()))
+	{
+		SetGameStateController(InWorld.GetGameState());
+	}
+}
+
+UTrickyGameModeSubsystem* UTrickyGameModeSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? World->GetSubsystem<UTrickyGameModeSubsystem>() : nullptr;
+}
+
+bool UTrickyGameModeSubsystem::SetGameStateController(UObject* Controller)
+{
+	if (!IsValid(Controller) || !Controller->Implements<UGameStateControllerInterface>())
+	{
+		return false;
+	}
+
+	GameStateController = Controller;
+	ControllerCaller = FGameStateControllerCaller(Controller);
+	return true;
+}
+
+void UTrickyGameModeSubsystem::ResetGameStateController(const UObject* Controller)
+{
+	if (GameStateController != Controller)
+	{
+		return;
+	}
+
+	GameStateController = nullptr;
+	ControllerCaller = FGameStateControllerCaller();
+}
+
+bool UTrickyGameModeSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UTrickyGameModeSubsystem::HandleGameModeInitialized(AGameModeBase* GameMode)
+{
+	if (!IsValid(GameMode) || GameMode->GetWorld() != GetWorld())
+	{
+		return;
+	}
+
+	SetGameStateController(GameMode);
+}
+
+void UTrickyGameModeSubsystem::HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	GameStateController = nullptr;
+	ControllerCaller = FGameStateControllerCaller();
+}
@@ -0,0 +1,77 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyGameModeTrace.h"
+
+#if TRICKY_GAME_MODE_TRACE_ENABLED
+
+#include "Misc/CString.h"
+#include "ProfilingDebugging/MiscTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(TrickyGameModeChannel)
+
+UE_TRACE_EVENT_BEGIN(TrickyGameMode, Transition)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, GameModeId)
+	UE_TRACE_EVENT_FIELD(double, Timestamp)
+	UE_TRACE_EVENT_FIELD(uint8, FromState)
+	UE_TRACE_EVENT_FIELD(uint8, ToState)
+	UE_TRACE_EVENT_FIELD(uint8, FromReason)
+	UE_TRACE_EVENT_FIELD(uint8, ToReason)
+	UE_TRACE_EVENT_FIELD(uint8, Result)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(TrickyGameMode, Timer)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, GameModeId)
+	UE_TRACE_EVENT_FIELD(double, Timestamp)
+	UE_TRACE_EVENT_FIELD(uint8, TimerType)
+	UE_TRACE_EVENT_FIELD(uint8, Action)
+	UE_TRACE_EVENT_FIELD(float, Time)
+UE_TRACE_EVENT_END()
+
+void FTrickyGameModeTrace::OutputTransition(const UObject* GameMode, const FTrickyGameStateTransition& InTransition)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(TrickyGameModeChannel))
+	{
+		return;
+	}
+
+	UE_TRACE_LOG(TrickyGameMode, Transition, TrickyGameModeChannel)
+		<< Transition.Cycle(FPlatformTime::Cycles64())
+		<< Transition.GameModeId(GameMode ? GameMode->GetUniqueID() : 0)
+		<< Transition.Timestamp(InTransition.Timestamp)
+		<< Transition.FromState(static_cast<uint8>(InTransition.FromState))
+		<< Transition.ToState(static_cast<uint8>(InTransition.ToState))
+		<< Transition.FromReason(static_cast<uint8>(InTransition.FromReason))
+		<< Transition.ToReason(static_cast<uint8>(InTransition.ToReason))
+		<< Transition.Result(static_cast<uint8>(InTransition.Result));
+
+	TRACE_BOOKMARK(TEXT("TrickyGameMode %s(%s) -> %s(%s)"),
+	               LexToString(InTransition.FromState),
+	               LexToString(InTransition.FromReason),
+	               LexToString(InTransition.ToState),
+	               LexToString(InTransition.ToReason));
+}
+
+void FTrickyGameModeTrace::OutputTimer(const UObject* GameMode,
+                                       const ETrickyTimerTraceType TimerType,
+                                       const ETrickyTimerTraceAction Action,
+                                       const double Timestamp,
+                                       const float Time)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(TrickyGameModeChannel))
+	{
+		return;
+	}
+
+	UE_TRACE_LOG(TrickyGameMode, Timer, TrickyGameModeChannel)
+		<< Timer.Cycle(FPlatformTime::Cycles64())
+		<< Timer.GameModeId(GameMode ? GameMode->GetUniqueID() : 0)
+		<< Timer.Timestamp(Timestamp)
+		<< Timer.TimerType(static_cast<uint8>(TimerType))
+		<< Timer.Action(static_cast<uint8>(Action))
+		<< Timer.Time(Time);
+}
+
+#endif
@@ -0,0 +1,87 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameStateControllerInterface.h"
+#include "TrickyBroadcastProfiler.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Config.h"
+
+#if !defined(TRICKY_GAME_MODE_TRACE_ENABLED)
+#define TRICKY_GAME_MODE_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+#endif
+
+enum class ETrickyTimerTraceType : uint8
+{
+	Preparation,
+	Game
+};
+
+enum class ETrickyTimerTraceAction : uint8
+{
+	Start,
+	Stop,
+	Pause,
+	UnPause,
+	Finish
+};
+
+#if TRICKY_GAME_MODE_TRACE_ENABLED
+
+#include "Trace/Trace.h"
+
+UE_TRACE_CHANNEL_EXTERN(TrickyGameModeChannel)
+
+/**
+ * Emits events of the game state machine to the TrickyGameMode trace channel.
+ * Enable it in Unreal Insights or with -trace=cpu,bookmark,TrickyGameMode.
+ */
+struct FTrickyGameModeTrace
+{
+	static void OutputTransition(const UObject* GameMode, const FTrickyGameStateTransition& InTransition);
+
+	static void OutputTimer(const UObject* GameMode,
+	                        const ETrickyTimerTraceType TimerType,
+	                        const ETrickyTimerTraceAction Action,
+	                        const double Timestamp,
+	                        const float Time);
+};
+
+#define TRACE_TRICKY_GAME_MODE_TRANSITION(GameMode, Transition) \
+	FTrickyGameModeTrace::OutputTransition(GameMode, Transition);
+
+#define TRACE_TRICKY_GAME_MODE_TIMER(GameMode, Timer, Action, Timestamp, Time) \
+	FTrickyGameModeTrace::OutputTimer(GameMode, ETrickyTimerTraceType::Timer, ETrickyTimerTraceAction::Action, Timestamp, Time);
+
+#else
+
+#define TRACE_TRICKY_GAME_MODE_TRANSITION(GameMode, Transition)
+#define TRACE_TRICKY_GAME_MODE_TIMER(GameMode, Timer, Action, Timestamp, Time)
+
+#endif
+
+/**
+ * Broadcasts a delegate inside a CPU profiler scope named after it.
+ * Goes through FTrickyBroadcastProfiler if TrickyGameMode.ProfileBroadcasts is enabled.
+ */
+#if TRICKY_GAME_MODE_BROADCAST_PROFILER_ENABLED
+#define TRICKY_GAME_MODE_BROADCAST(Delegate, ...) \
+	{ \
+		TRACE_CPUPROFILER_EVENT_SCOPE_STR("TrickyGameMode::" #Delegate); \
+		if (FTrickyBroadcastProfiler::IsEnabled()) \
+		{ \
+			FTrickyBroadcastProfiler::Broadcast(TEXT(#Delegate), Delegate, ##__VA_ARGS__); \
+		} \
+		else \
+		{ \
+			Delegate.Broadcast(__VA_ARGS__); \
+		} \
+	}
+#else
+#define TRICKY_GAME_MODE_BROADCAST(Delegate, ...) \
+	{ \
+		TRACE_CPUPROFILER_EVENT_SCOPE_STR("TrickyGameMode::" #Delegate); \
+		Delegate.Broadcast(__VA_ARGS__); \
+	}
+#endif
@@ -0,0 +1,264 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyGameStateAsyncActions.h"
+
+#include "TrickyGameModeBase.h"
+#include "TrickyGameModeLibrary.h"
+#include "TrickyGameStateBase.h"
+#include "TrickyMilestoneScheduler.h"
+
+void UTrickyGameStateAsyncAction::Activate()
+{
+	Super::Activate();
+
+	// Clients don't have a game mode, so only the game state is available there.
+	GameMode = UTrickyGameModeLibrary::GetTrickyGameMode(WorldContext.Get());
+	GameState = UTrickyGameModeLibrary::GetTrickyGameState(WorldContext.Get());
+
+	if (IsConditionMet())
+	{
+		Complete();
+		return;
+	}
+
+	if (!Subscribe())
+	{
+#if WITH_EDITOR || !UE_BUILD_SHIPPING
+		UE_LOG(LogTrickyGameMode,
+		       Warning,
+		       TEXT("%s can't wait, there is no TrickyGameModeBase or TrickyGameStateBase"),
+		       *GetClass()->GetName());
+#endif
+
+		SetReadyToDestroy();
+		return;
+	}
+
+	bIsActive = true;
+	AActor* Owner = GameMode.IsValid() ? Cast<AActor>(GameMode.Get()) : Cast<AActor>(GameState.Get());
+	Owner->OnEndPlay.AddDynamic(this, &UTrickyGameStateAsyncAction::HandleEndPlay);
+}
+
+void UTrickyGameStateAsyncAction::SetReadyToDestroy()
+{
+	if (bIsActive)
+	{
+		bIsActive = false;
+		Unsubscribe();
+
+		if (GameMode.IsValid())
+		{
+			GameMode->OnEndPlay.RemoveDynamic(this, &UTrickyGameStateAsyncAction::HandleEndPlay);
+		}
+
+		if (GameState.IsValid())
+		{
+			GameState->OnEndPlay.RemoveDynamic(this, &UTrickyGameStateAsyncAction::HandleEndPlay);
+		}
+	}
+
+	Super::SetReadyToDestroy();
+}
+
+void UTrickyGameStateAsyncAction::Complete()
+{
+	Completed.Broadcast();
+	SetReadyToDestroy();
+}
+
+void UTrickyGameStateAsyncAction::HandleTransition(const FTrickyGameStateTransition& Transition)
+{
+	Complete();
+}
+
+void UTrickyGameStateAsyncAction::CompleteIfConditionMet()
+{
+	if (bIsActive && IsConditionMet())
+	{
+		Complete();
+	}
+}
+
+void UTrickyGameStateAsyncAction::HandleEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	SetReadyToDestroy();
+}
+
+UTrickyWaitForGameStateAction* UTrickyWaitForGameStateAction::WaitForGameState(UObject* WorldContextObject,
+                                                                              const ETrickyGameState State)
+{
+	UTrickyWaitForGameStateAction* Action = NewObject<UTrickyWaitForGameStateAction>();
+	Action->WorldContext = WorldContextObject;
+	Action->State = State;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+bool UTrickyWaitForGameStateAction::IsConditionMet() const
+{
+	const bool bHasController = GameMode.IsValid() || GameState.IsValid();
+	return bHasController && UTrickyGameModeLibrary::GetGameState(WorldContext.Get()) == State;
+}
+
+bool UTrickyWaitForGameStateAction::Subscribe()
+{
+	if (GameMode.IsValid())
+	{
+		TransitionHandle = GameMode->SubscribeToTransition(
+			FTrickyTransitionFilter::MakeTo(State),
+			FOnGameStateTransitionSignature::FDelegate::CreateUObject(this, &ThisClass::HandleTransition));
+		return true;
+	}
+
+	if (GameState.IsValid())
+	{
+		GameState->OnGameStateChanged.AddDynamic(this, &ThisClass::HandleGameStateChanged);
+		return true;
+	}
+
+	return false;
+}
+
+void UTrickyWaitForGameStateAction::Unsubscribe()
+{
+	if (GameMode.IsValid())
+	{
+		GameMode->UnsubscribeFromTransition(TransitionHandle);
+	}
+
+	if (GameState.IsValid())
+	{
+		GameState->OnGameStateChanged.RemoveDynamic(this, &ThisClass::HandleGameStateChanged);
+	}
+}
+
+void UTrickyWaitForGameStateAction::HandleGameStateChanged(const ETrickyGameState NewState)
+{
+	CompleteIfConditionMet();
+}
+
+UTrickyWaitForInactivityReasonAction* UTrickyWaitForInactivityReasonAction::WaitForInactivityReason(
+	UObject* WorldContextObject,
+	const EGameInactivityReason Reason)
+{
+	UTrickyWaitForInactivityReasonAction* Action = NewObject<UTrickyWaitForInactivityReasonAction>();
+	Action->WorldContext = WorldContextObject;
+	Action->Reason = Reason;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+bool UTrickyWaitForInactivityReasonAction::IsConditionMet() const
+{
+	const bool bHasController = GameMode.IsValid() || GameState.IsValid();
+	return bHasController && UTrickyGameModeLibrary::GetInactivityReason(WorldContext.Get()) == Reason;
+}
+
+bool UTrickyWaitForInactivityReasonAction::Subscribe()
+{
+	if (GameMode.IsValid())
+	{
+		FTrickyTransitionFilter Filter = FTrickyTransitionFilter::MakeTo(ETrickyGameState::Inactive).WithReason(Reason);
+
+		// The game is never inactive without a reason, so the None reason is reached by leaving the inactive state.
+		if (Reason == EGameInactivityReason::None)
+		{
+			Filter = FTrickyTransitionFilter();
+			Filter.FromStateMask = FTrickyTransitionFilter::ToMask(ETrickyGameState::Inactive);
+			Filter.ToStateMask &= ~FTrickyTransitionFilter::ToMask(ETrickyGameState::Inactive);
+		}
+
+		TransitionHandle = GameMode->SubscribeToTransition(
+			Filter,
+			FOnGameStateTransitionSignature::FDelegate::CreateUObject(this, &ThisClass::HandleTransition));
+		return true;
+	}
+
+	if (GameState.IsValid())
+	{
+		GameState->OnInactivityReasonChanged.AddDynamic(this, &ThisClass::HandleInactivityReasonChanged);
+		return true;
+	}
+
+	return false;
+}
+
+void UTrickyWaitForInactivityReasonAction::Unsubscribe()
+{
+	if (GameMode.IsValid())
+	{
+		GameMode->UnsubscribeFromTransition(TransitionHandle);
+	}
+
+	if (GameState.IsValid())
+	{
+		GameState->OnInactivityReasonChanged.RemoveDynamic(this, &ThisClass::HandleInactivityReasonChanged);
+	}
+}
+
+void UTrickyWaitForInactivityReasonAction::HandleInactivityReasonChanged(const EGameInactivityReason NewReason)
+{
+	CompleteIfConditionMet();
+}
+
+UTrickyWaitForRemainingTimeAction* UTrickyWaitForRemainingTimeAction::WaitForRemainingTime(
+	UObject* WorldContextObject,
+	const float Time)
+{
+	UTrickyWaitForRemainingTimeAction* Action = NewObject<UTrickyWaitForRemainingTimeAction>();
+	Action->WorldContext = WorldContextObject;
+	Action->Time = FMath::Max(Time, 0.f);
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+bool UTrickyWaitForRemainingTimeAction::IsConditionMet() const
+{
+	if (!GameState.IsValid())
+	{
+		return false;
+	}
+
+	// GetRemaining returns a negative value for inactive or unlimited timers.
+	const double RemainingTime = GameState->GetGameTimer().GetRemaining(GameState->GetServerWorldTimeSeconds());
+	return RemainingTime >= 0.0 && RemainingTime <= Time;
+}
+
+bool UTrickyWaitForRemainingTimeAction::Subscribe()
+{
+	if (!GameState.IsValid())
+	{
+		return false;
+	}
+
+	FTrickyTimerMilestone Milestone;
+	Milestone.Type = ETrickyMilestoneType::Remaining;
+	Milestone.Time = Time;
+	MilestoneHandle = GameState->AddGameMilestone(
+		Milestone,
+		FOnTimerMilestoneSignature::FDelegate::CreateUObject(this, &ThisClass::HandleMilestoneReached));
+
+	// A milestone beyond the game duration is never reached, so such waits complete when the timer starts.
+	GameTimerHandle = GameState->OnGameTimerChangedNative.AddUObject(this, &ThisClass::HandleGameTimerChanged);
+	return true;
+}
+
+void UTrickyWaitForRemainingTimeAction::Unsubscribe()
+{
+	if (GameState.IsValid())
+	{
+		GameState->RemoveGameMilestone(MilestoneHandle);
+		GameState->OnGameTimerChangedNative.Remove(GameTimerHandle);
+	}
+}
+
+void UTrickyWaitForRemainingTimeAction::HandleMilestoneReached(const FTrickyTimerMilestone& Milestone)
+{
+	Complete();
+}
+
+void UTrickyWaitForRemainingTimeAction::HandleGameTimerChanged(const FTrickyTimerStamp& Timer)
+{
+	CompleteIfConditionMet();
+}
@@ -0,0 +1,413 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyGameStateBase.h"
+
+#include "TrickyGameModeSubsystem.h"
+#include "TimerManager.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+namespace TrickyReplicatedGameState
+{
+	// ETrickyGameState has 3 values, EGameInactivityReason has 6 and EGameResult has 5.
+	constexpr uint32 StateBits = 2;
+	constexpr uint32 ReasonBits = 3;
+	constexpr uint32 ResultBits = 3;
+	constexpr uint32 TotalBits = StateBits * 2 + ReasonBits + ResultBits;
+
+	constexpr uint32 StateMask = (1 << StateBits) - 1;
+	constexpr uint32 ReasonMask = (1 << ReasonBits) - 1;
+	constexpr uint32 ResultMask = (1 << ResultBits) - 1;
+}
+
+bool FTrickyReplicatedGameState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	using namespace TrickyReplicatedGameState;
+
+	uint32 Packed = 0;
+
+	if (Ar.IsSaving())
+	{
+		Packed = static_cast<uint32>(State)
+			| (static_cast<uint32>(LastState) << StateBits)
+			| (static_cast<uint32>(InactivityReason) << (StateBits * 2))
+			| (static_cast<uint32>(Result) << (StateBits * 2 + ReasonBits));
+	}
+
+	Ar.SerializeBits(&Packed, TotalBits);
+
+	if (Ar.IsLoading())
+	{
+		State = static_cast<ETrickyGameState>(Packed & StateMask);
+		LastState = static_cast<ETrickyGameState>((Packed >> StateBits) & StateMask);
+		InactivityReason = static_cast<EGameInactivityReason>((Packed >> (StateBits * 2)) & ReasonMask);
+		Result = static_cast<EGameResult>((Packed >> (StateBits * 2 + ReasonBits)) & ResultMask);
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+bool FTrickyReplicatedGameState::operator==(const FTrickyReplicatedGameState& Other) const
+{
+	return State == Other.State
+		&& LastState == Other.LastState
+		&& InactivityReason == Other.InactivityReason
+		&& Result == Other.Result;
+}
+
+ATrickyGameStateBase::ATrickyGameStateBase()
+{
+	bReplicates = true;
+}
+
+void ATrickyGameStateBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATrickyGameStateBase, ReplicatedState, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATrickyGameStateBase, PreparationTimer, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATrickyGameStateBase, GameTimer, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATrickyGameStateBase, CurrentRound, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATrickyGameStateBase, ReadyCheck, Params);
+}
+
+void ATrickyGameStateBase::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// Dedicated servers have no UI, so the view model would only format text and re-arm its timer for nothing.
+	if (CountdownViewModelClass && GetNetMode() != NM_DedicatedServer)
+	{
+		CountdownViewModel = NewObject<UTrickyCountdownViewModel>(this, CountdownViewModelClass);
+		CountdownViewModel->Initialize(this);
+	}
+
+	for (const FTrickyTimerMilestone& Milestone : PreparationMilestones)
+	{
+		PreparationMilestoneScheduler.Add(Milestone,
+		                                  FOnTimerMilestoneSignature::FDelegate::CreateUObject(
+			                                  this,
+			                                  &ATrickyGameStateBase::HandlePreparationMilestoneReached));
+	}
+
+	for (const FTrickyTimerMilestone& Milestone : GameMilestones)
+	{
+		GameMilestoneScheduler.Add(Milestone,
+		                           FOnTimerMilestoneSignature::FDelegate::CreateUObject(
+			                           this,
+			                           &ATrickyGameStateBase::HandleGameMilestoneReached));
+	}
+
+	if (HasAuthority())
+	{
+		return;
+	}
+
+	if (UTrickyGameModeSubsystem* Subsystem = UTrickyGameModeSubsystem::Get(this))
+	{
+		Subsystem->SetGameStateController(this);
+	}
+}
+
+void ATrickyGameStateBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorldTimerManager().ClearTimer(PreparationPredictionHandle);
+	PreparationMilestoneScheduler.Reset();
+	GameMilestoneScheduler.Reset();
+
+	if (CountdownViewModel)
+	{
+		CountdownViewModel->Deinitialize();
+	}
+
+	if (UTrickyGameModeSubsystem* Subsystem = UTrickyGameModeSubsystem::Get(this))
+	{
+		Subsystem->ResetGameStateController(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ATrickyGameStateBase::SetReplicatedState(const FTrickyReplicatedGameState& NewState)
+{
+	if (!HasAuthority() || ReplicatedState == NewState)
+	{
+		return;
+	}
+
+	const FTrickyReplicatedGameState PreviousState = ReplicatedState;
+	ReplicatedState = NewState;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ATrickyGameStateBase, ReplicatedState, this);
+	ForceNetUpdate();
+	BroadcastStateChanges(PreviousState);
+}
+
+void ATrickyGameStateBase::SetPreparationTimer(const FTrickyTimerStamp& NewTimer)
+{
+	if (!HasAuthority() || PreparationTimer == NewTimer)
+	{
+		return;
+	}
+
+	PreparationTimer = NewTimer;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ATrickyGameStateBase, PreparationTimer, this);
+	ForceNetUpdate();
+	PreparationMilestoneScheduler.Sync(GetWorld(), PreparationTimer, GetServerWorldTimeSeconds());
+	RefreshCountdownViewModel();
+}
+
+void ATrickyGameStateBase::SetGameTimer(const FTrickyTimerStamp& NewTimer)
+{
+	if (!HasAuthority() || GameTimer == NewTimer)
+	{
+		return;
+	}
+
+	GameTimer = NewTimer;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ATrickyGameStateBase, GameTimer, this);
+	ForceNetUpdate();
+	GameMilestoneScheduler.Sync(GetWorld(), GameTimer, GetServerWorldTimeSeconds());
+	RefreshCountdownViewModel();
+	OnGameTimerChangedNative.Broadcast(GameTimer);
+}
+
+void ATrickyGameStateBase::SetCurrentRound(const int32 NewRound)
+{
+	if (!HasAuthority() || CurrentRound == NewRound)
+	{
+		return;
+	}
+
+	CurrentRound = NewRound;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ATrickyGameStateBase, CurrentRound, this);
+	OnRoundChanged.Broadcast(CurrentRound);
+}
+
+void ATrickyGameStateBase::SetReadyCheck(const FTrickyReadyCheck& NewReadyCheck)
+{
+	if (!HasAuthority() || ReadyCheck == NewReadyCheck)
+	{
+		return;
+	}
+
+	ReadyCheck = NewReadyCheck;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ATrickyGameStateBase, ReadyCheck, this);
+	OnReadyCheckChanged.Broadcast(ReadyCheck.ReadyNum, ReadyCheck.ConnectedNum);
+}
+
+FDelegateHandle ATrickyGameStateBase::AddPreparationMilestone(const FTrickyTimerMilestone& Milestone,
+                                                              FOnTimerMilestoneSignature::FDelegate&& Delegate)
+{
+	return PreparationMilestoneScheduler.Add(Milestone, MoveTemp(Delegate));
+}
+
+bool ATrickyGameStateBase::RemovePreparationMilestone(const FDelegateHandle Handle)
+{
+	return PreparationMilestoneScheduler.Remove(Handle);
+}
+
+FDelegateHandle ATrickyGameStateBase::AddGameMilestone(const FTrickyTimerMilestone& Milestone,
+                                                       FOnTimerMilestoneSignature::FDelegate&& Delegate)
+{
+	return GameMilestoneScheduler.Add(Milestone, MoveTemp(Delegate));
+}
+
+bool ATrickyGameStateBase::RemoveGameMilestone(const FDelegateHandle Handle)
+{
+	return GameMilestoneScheduler.Remove(Handle);
+}
+
+float ATrickyGameStateBase::GetPreparationElapsedTime() const
+{
+	return static_cast<float>(PreparationTimer.GetElapsed(GetServerWorldTimeSeconds()));
+}
+
+float ATrickyGameStateBase::GetPreparationRemainingTime() const
+{
+	return static_cast<float>(PreparationTimer.GetRemaining(GetServerWorldTimeSeconds()));
+}
+
+ETrickyGameState ATrickyGameStateBase::GetGameState_Implementation() const
+{
+	return GetEffectiveState().State;
+}
+
+EGameResult ATrickyGameStateBase::GetGameResult_Implementation() const
+{
+	const FTrickyReplicatedGameState& State = GetEffectiveState();
+
+	if (State.State != ETrickyGameState::Finished)
+	{
+		return EGameResult::None;
+	}
+
+	return State.Result;
+}
+
+EGameInactivityReason ATrickyGameStateBase::GetGameInactivityReason_Implementation() const
+{
+	const FTrickyReplicatedGameState& State = GetEffectiveState();
+
+	if (State.State != ETrickyGameState::Inactive)
+	{
+		return EGameInactivityReason::None;
+	}
+
+	return State.InactivityReason;
+}
+
+float ATrickyGameStateBase::GetGameElapsedTime_Implementation() const
+{
+	return static_cast<float>(GameTimer.GetElapsed(GetServerWorldTimeSeconds()));
+}
+
+float ATrickyGameStateBase::GetGameRemainingTime_Implementation() const
+{
+	const double Now = GetServerWorldTimeSeconds();
+
+	// Mirrors the game mode, which returns the elapsed time for sessions without a time limit.
+	return static_cast<float>(GameTimer.IsLimited() ? GameTimer.GetRemaining(Now) : GameTimer.GetElapsed(Now));
+}
+
+void ATrickyGameStateBase::OnRep_ReplicatedState(const FTrickyReplicatedGameState& PreviousState)
+{
+	// Listeners were already notified about the predicted state, so only the difference is broadcast.
+	const FTrickyReplicatedGameState LastKnownState = bIsStatePredicted ? PredictedState : PreviousState;
+	bIsStatePredicted = false;
+	BroadcastStateChanges(LastKnownState);
+	UpdatePreparationPrediction();
+}
+
+void ATrickyGameStateBase::OnRep_PreparationTimer()
+{
+	RollBackPreparationPrediction();
+	UpdatePreparationPrediction();
+	PreparationMilestoneScheduler.Sync(GetWorld(), PreparationTimer, GetServerWorldTimeSeconds());
+	RefreshCountdownViewModel();
+}
+
+void ATrickyGameStateBase::OnRep_GameTimer()
+{
+	GameMilestoneScheduler.Sync(GetWorld(), GameTimer, GetServerWorldTimeSeconds());
+	RefreshCountdownViewModel();
+	OnGameTimerChangedNative.Broadcast(GameTimer);
+}
+
+void ATrickyGameStateBase::OnRep_CurrentRound()
+{
+	OnRoundChanged.Broadcast(CurrentRound);
+}
+
+void ATrickyGameStateBase::OnRep_ReadyCheck()
+{
+	OnReadyCheckChanged.Broadcast(ReadyCheck.ReadyNum, ReadyCheck.ConnectedNum);
+}
+
+void ATrickyGameStateBase::HandlePreparationMilestoneReached(const FTrickyTimerMilestone& Milestone)
+{
+	OnPreparationMilestoneReached.Broadcast(Milestone);
+}
+
+void ATrickyGameStateBase::HandleGameMilestoneReached(const FTrickyTimerMilestone& Milestone)
+{
+	OnGameMilestoneReached.Broadcast(Milestone);
+}
+
+void ATrickyGameStateBase::BroadcastStateChanges(const FTrickyReplicatedGameState& PreviousState)
+{
+	const FTrickyReplicatedGameState& State = GetEffectiveState();
+
+	if (PreviousState.State != State.State)
+	{
+		OnGameStateChanged.Broadcast(State.State);
+	}
+
+	if (PreviousState.InactivityReason != State.InactivityReason)
+	{
+		OnInactivityReasonChanged.Broadcast(State.InactivityReason);
+	}
+
+	const bool bHasFinished = State.State == ETrickyGameState::Finished
+		&& (PreviousState.State != ETrickyGameState::Finished || PreviousState.Result != State.Result);
+
+	if (bHasFinished)
+	{
+		OnGameFinished.Broadcast(State.Result);
+	}
+
+	RefreshCountdownViewModel();
+}
+
+void ATrickyGameStateBase::RefreshCountdownViewModel() const
+{
+	if (CountdownViewModel)
+	{
+		CountdownViewModel->Refresh();
+	}
+}
+
+void ATrickyGameStateBase::UpdatePreparationPrediction()
+{
+	FTimerManager& TimerManager = GetWorldTimerManager();
+	TimerManager.ClearTimer(PreparationPredictionHandle);
+
+	const bool bIsPreparing = ReplicatedState.State == ETrickyGameState::Inactive
+		&& ReplicatedState.InactivityReason == EGameInactivityReason::Preparation;
+
+	if (HasAuthority() || bIsStatePredicted || !bIsPreparing || PreparationTimer.IsPaused())
+	{
+		return;
+	}
+
+	const double RemainingTime = PreparationTimer.GetRemaining(GetServerWorldTimeSeconds());
+
+	if (RemainingTime <= 0.0)
+	{
+		return;
+	}
+
+	TimerManager.SetTimer(PreparationPredictionHandle,
+	                      this,
+	                      &ATrickyGameStateBase::HandlePreparationPredictionFinished,
+	                      static_cast<float>(RemainingTime),
+	                      false);
+}
+
+void ATrickyGameStateBase::HandlePreparationPredictionFinished()
+{
+	const FTrickyReplicatedGameState PreviousState = ReplicatedState;
+
+	// Mirrors HandlePreparationTimerFinished on the server, which starts the game.
+	PredictedState = ReplicatedState;
+	PredictedState.LastState = ReplicatedState.State;
+	PredictedState.State = ETrickyGameState::Active;
+	PredictedState.InactivityReason = EGameInactivityReason::None;
+	PredictedPreparationEndTime = PreparationTimer.StartTime + PreparationTimer.PauseOffset + PreparationTimer.Duration;
+	bIsStatePredicted = true;
+
+	BroadcastStateChanges(PreviousState);
+}
+
+void ATrickyGameStateBase::RollBackPreparationPrediction()
+{
+	if (!bIsStatePredicted || !PreparationTimer.IsActive())
+	{
+		return;
+	}
+
+	const double EndTime = PreparationTimer.StartTime + PreparationTimer.PauseOffset + PreparationTimer.Duration;
+
+	if (!PreparationTimer.IsPaused() && EndTime <= PredictedPreparationEndTime)
+	{
+		return;
+	}
+
+	const FTrickyReplicatedGameState LastKnownState = PredictedState;
+	bIsStatePredicted = false;
+	BroadcastStateChanges(LastKnownState);
+}
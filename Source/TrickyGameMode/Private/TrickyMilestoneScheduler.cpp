@@ -0,0 +1,244 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyMilestoneScheduler.h"
+
+#include "Engine/World.h"
+
+double FTrickyTimerMilestone::GetElapsedTime(const float Duration) const
+{
+	if (Type == ETrickyMilestoneType::Elapsed)
+	{
+		return Duration > 0.f && Time > Duration ? -1.0 : Time;
+	}
+
+	return Duration > 0.f && Time <= Duration ? Duration - Time : -1.0;
+}
+
+FTrickyMilestoneScheduler::~FTrickyMilestoneScheduler()
+{
+	ClearTimer();
+}
+
+FDelegateHandle FTrickyMilestoneScheduler::Add(const FTrickyTimerMilestone& Milestone,
+                                               FOnTimerMilestoneSignature::FDelegate&& Delegate)
+{
+	if (!Delegate.IsBound())
+	{
+		return FDelegateHandle();
+	}
+
+	FListener& Listener = Listeners.AddDefaulted_GetRef();
+	Listener.Handle = FDelegateHandle(FDelegateHandle::GenerateNewHandle);
+	Listener.Milestone = Milestone;
+	Listener.Delegate = MoveTemp(Delegate);
+	const FDelegateHandle Handle = Listener.Handle;
+
+	if (bIsInvoking)
+	{
+		bIsScheduleDirty = true;
+	}
+	else if (SyncedStamp.IsActive())
+	{
+		Reschedule();
+	}
+
+	return Handle;
+}
+
+bool FTrickyMilestoneScheduler::Remove(const FDelegateHandle Handle)
+{
+	const int32 Index = Listeners.IndexOfByPredicate([&Handle](const FListener& Listener)
+	{
+		return Listener.Handle == Handle;
+	});
+
+	if (!Handle.IsValid() || Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	if (bIsInvoking)
+	{
+		// The schedule refers to the listeners by index, so they're removed after the invocation.
+		Listeners[Index].Delegate.Unbind();
+		bIsScheduleDirty = true;
+		return true;
+	}
+
+	Listeners.RemoveAt(Index);
+
+	if (SyncedStamp.IsActive())
+	{
+		Reschedule();
+	}
+	else
+	{
+		Schedule.Reset();
+		NextIndex = 0;
+	}
+
+	return true;
+}
+
+void FTrickyMilestoneScheduler::Sync(UWorld* InWorld, const FTrickyTimerStamp& Stamp, const double Now)
+{
+	if (SyncedStamp == Stamp && World.Get() == InWorld)
+	{
+		return;
+	}
+
+	const FTrickyTimerStamp PreviousStamp = SyncedStamp;
+	SyncedStamp = Stamp;
+	World = InWorld;
+	ClockOffset = IsValid(InWorld) ? Now - InWorld->GetTimeSeconds() : 0.0;
+	ClearTimer();
+
+	if (PreviousStamp.StartTime != Stamp.StartTime)
+	{
+		ReachedElapsedTime = -1.0;
+	}
+
+	// A listener changed the timer, the schedule is rebuilt once the invocation ends.
+	if (bIsInvoking)
+	{
+		bIsScheduleDirty = true;
+		return;
+	}
+
+	if (!Stamp.IsActive())
+	{
+		// Milestones at the very end of the timer are due at the same moment as the timer itself.
+		if (PreviousStamp.IsLimited() && PreviousStamp.GetRemaining(Now) <= UE_KINDA_SMALL_NUMBER)
+		{
+			InvokeMilestones(PreviousStamp.Duration);
+		}
+
+		Schedule.Reset();
+		NextIndex = 0;
+		return;
+	}
+
+	Reschedule();
+}
+
+void FTrickyMilestoneScheduler::Reset()
+{
+	ClearTimer();
+	Listeners.Reset();
+	Schedule.Reset();
+	NextIndex = 0;
+	ReachedElapsedTime = -1.0;
+	SyncedStamp.Stop();
+	bIsScheduleDirty = false;
+}
+
+void FTrickyMilestoneScheduler::ClearTimer()
+{
+	if (UWorld* CurrentWorld = World.Get())
+	{
+		CurrentWorld->GetTimerManager().ClearTimer(TimerHandle);
+	}
+
+	TimerHandle.Invalidate();
+}
+
+void FTrickyMilestoneScheduler::Reschedule()
+{
+	ClearTimer();
+	Schedule.Reset();
+	NextIndex = 0;
+
+	const UWorld* CurrentWorld = World.Get();
+
+	if (!IsValid(CurrentWorld) || !SyncedStamp.IsActive())
+	{
+		return;
+	}
+
+	const double ElapsedTime = SyncedStamp.GetElapsed(CurrentWorld->GetTimeSeconds() + ClockOffset);
+
+	for (int32 Index = 0; Index < Listeners.Num(); ++Index)
+	{
+		const double MilestoneTime = Listeners[Index].Milestone.GetElapsedTime(SyncedStamp.Duration);
+
+		// Milestones which were already reached or passed during this run aren't invoked again.
+		if (MilestoneTime >= ElapsedTime && MilestoneTime > ReachedElapsedTime)
+		{
+			Schedule.Add({MilestoneTime, Index});
+		}
+	}
+
+	Schedule.StableSort([](const FScheduledMilestone& A, const FScheduledMilestone& B)
+	{
+		return A.ElapsedTime < B.ElapsedTime;
+	});
+
+	ArmNextMilestone(ElapsedTime);
+}
+
+void FTrickyMilestoneScheduler::ArmNextMilestone(const double ElapsedTime)
+{
+	UWorld* CurrentWorld = World.Get();
+
+	if (!IsValid(CurrentWorld) || !Schedule.IsValidIndex(NextIndex))
+	{
+		return;
+	}
+
+	FTimerManager& TimerManager = CurrentWorld->GetTimerManager();
+	const double Delay = FMath::Max(Schedule[NextIndex].ElapsedTime - ElapsedTime, UE_KINDA_SMALL_NUMBER);
+	TimerManager.SetTimer(TimerHandle,
+	                      FTimerDelegate::CreateRaw(this, &FTrickyMilestoneScheduler::HandleMilestoneDue),
+	                      static_cast<float>(Delay),
+	                      false);
+
+	if (SyncedStamp.IsPaused())
+	{
+		TimerManager.PauseTimer(TimerHandle);
+	}
+}
+
+void FTrickyMilestoneScheduler::HandleMilestoneDue()
+{
+	TimerHandle.Invalidate();
+
+	if (!Schedule.IsValidIndex(NextIndex))
+	{
+		return;
+	}
+
+	const double ElapsedTime = Schedule[NextIndex].ElapsedTime;
+	InvokeMilestones(ElapsedTime);
+
+	if (!TimerHandle.IsValid())
+	{
+		ArmNextMilestone(ElapsedTime);
+	}
+}
+
+void FTrickyMilestoneScheduler::InvokeMilestones(const double ElapsedTime)
+{
+	bIsInvoking = true;
+
+	while (Schedule.IsValidIndex(NextIndex) && Schedule[NextIndex].ElapsedTime <= ElapsedTime + UE_KINDA_SMALL_NUMBER)
+	{
+		const FScheduledMilestone& Scheduled = Schedule[NextIndex++];
+		ReachedElapsedTime = Scheduled.ElapsedTime;
+
+		// Listeners can be added during the invocation, so the listener is copied out of the array.
+		const FListener Listener = Listeners[Scheduled.ListenerIndex];
+		Listener.Delegate.ExecuteIfBound(Listener.Milestone);
+	}
+
+	bIsInvoking = false;
+
+	if (!bIsScheduleDirty)
+	{
+		return;
+	}
+
+	bIsScheduleDirty = false;
+	Listeners.RemoveAll([](const FListener& Listener) { return !Listener.Delegate.IsBound(); });
+	Reschedule();
+}
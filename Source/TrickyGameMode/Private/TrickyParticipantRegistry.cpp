@@ -0,0 +1,183 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyParticipantRegistry.h"
+
+void FTrickyParticipantRegistry::AddPlayer(const int32 Slot, const int32 Team)
+{
+	if (Slot < 0 || GetPlayerState(Slot) != ETrickyGameState::Inactive)
+	{
+		return;
+	}
+
+	if (Slot >= PlayerStates.Num())
+	{
+		PlayerStates.SetNum(Slot + 1);
+		PlayerResults.SetNum(Slot + 1);
+		PlayerTeams.SetNum(Slot + 1);
+	}
+
+	PlayerStates[Slot] = ETrickyGameState::Active;
+	PlayerResults[Slot] = EGameResult::None;
+	PlayerTeams[Slot] = INDEX_NONE;
+	AddAlive(Slot);
+	SetPlayerTeam(Slot, Team);
+}
+
+bool FTrickyParticipantRegistry::RemovePlayer(const int32 Slot)
+{
+	if (GetPlayerState(Slot) == ETrickyGameState::Inactive)
+	{
+		return false;
+	}
+
+	if (IsPlayerAlive(Slot))
+	{
+		RemoveAlive(Slot, EGameResult::None);
+	}
+
+	if (PlayerTeams[Slot] != INDEX_NONE)
+	{
+		--TeamPlayersNums[PlayerTeams[Slot]];
+		PlayerTeams[Slot] = INDEX_NONE;
+	}
+
+	PlayerStates[Slot] = ETrickyGameState::Inactive;
+	PlayerResults[Slot] = EGameResult::None;
+	return true;
+}
+
+bool FTrickyParticipantRegistry::SetPlayerTeam(const int32 Slot, const int32 Team)
+{
+	if (GetPlayerState(Slot) == ETrickyGameState::Inactive || PlayerTeams[Slot] == Team || Team < INDEX_NONE)
+	{
+		return false;
+	}
+
+	const bool bIsAlive = IsPlayerAlive(Slot);
+
+	// Moves the player between the teams as if it was removed and added again.
+	if (bIsAlive)
+	{
+		RemoveAlive(Slot, EGameResult::None);
+	}
+
+	if (PlayerTeams[Slot] != INDEX_NONE)
+	{
+		--TeamPlayersNums[PlayerTeams[Slot]];
+	}
+
+	PlayerTeams[Slot] = Team;
+
+	if (Team != INDEX_NONE)
+	{
+		if (Team >= TeamPlayersNums.Num())
+		{
+			TeamPlayersNums.SetNumZeroed(Team + 1);
+			TeamAliveNums.SetNumZeroed(Team + 1);
+			TeamResults.SetNum(Team + 1);
+		}
+
+		++TeamPlayersNums[Team];
+	}
+
+	if (bIsAlive)
+	{
+		AddAlive(Slot);
+	}
+
+	return true;
+}
+
+bool FTrickyParticipantRegistry::FinishPlayer(const int32 Slot, const EGameResult Result)
+{
+	if (!IsPlayerAlive(Slot))
+	{
+		return false;
+	}
+
+	PlayerStates[Slot] = ETrickyGameState::Finished;
+	PlayerResults[Slot] = Result;
+	RemoveAlive(Slot, Result);
+	return true;
+}
+
+void FTrickyParticipantRegistry::ResetResults()
+{
+	for (int32 Slot = 0; Slot < PlayerStates.Num(); ++Slot)
+	{
+		if (PlayerStates[Slot] != ETrickyGameState::Finished)
+		{
+			continue;
+		}
+
+		PlayerStates[Slot] = ETrickyGameState::Active;
+		PlayerResults[Slot] = EGameResult::None;
+		AddAlive(Slot);
+	}
+
+	for (EGameResult& TeamResult : TeamResults)
+	{
+		TeamResult = EGameResult::None;
+	}
+}
+
+ETrickyGameState FTrickyParticipantRegistry::GetPlayerState(const int32 Slot) const
+{
+	return PlayerStates.IsValidIndex(Slot) ? PlayerStates[Slot] : ETrickyGameState::Inactive;
+}
+
+EGameResult FTrickyParticipantRegistry::GetPlayerResult(const int32 Slot) const
+{
+	return PlayerResults.IsValidIndex(Slot) ? PlayerResults[Slot] : EGameResult::None;
+}
+
+int32 FTrickyParticipantRegistry::GetPlayerTeam(const int32 Slot) const
+{
+	return GetPlayerState(Slot) != ETrickyGameState::Inactive ? PlayerTeams[Slot] : INDEX_NONE;
+}
+
+int32 FTrickyParticipantRegistry::GetTeamAliveNum(const int32 Team) const
+{
+	return TeamAliveNums.IsValidIndex(Team) ? TeamAliveNums[Team] : 0;
+}
+
+ETrickyGameState FTrickyParticipantRegistry::GetTeamState(const int32 Team) const
+{
+	if (!TeamPlayersNums.IsValidIndex(Team) || TeamPlayersNums[Team] == 0)
+	{
+		return ETrickyGameState::Inactive;
+	}
+
+	return TeamAliveNums[Team] > 0 ? ETrickyGameState::Active : ETrickyGameState::Finished;
+}
+
+EGameResult FTrickyParticipantRegistry::GetTeamResult(const int32 Team) const
+{
+	return GetTeamState(Team) == ETrickyGameState::Finished ? TeamResults[Team] : EGameResult::None;
+}
+
+void FTrickyParticipantRegistry::AddAlive(const int32 Slot)
+{
+	++AliveNum;
+	const int32 Team = PlayerTeams[Slot];
+
+	if (Team != INDEX_NONE && TeamAliveNums[Team]++ == 0)
+	{
+		++TeamsRemainingNum;
+		TeamResults[Team] = EGameResult::None;
+	}
+}
+
+void FTrickyParticipantRegistry::RemoveAlive(const int32 Slot, const EGameResult Result)
+{
+	--AliveNum;
+	const int32 Team = PlayerTeams[Slot];
+
+	// The team gets the result of its last alive player.
+	if (Team != INDEX_NONE && --TeamAliveNums[Team] == 0)
+	{
+		--TeamsRemainingNum;
+		TeamResults[Team] = Result;
+	}
+}
@@ -0,0 +1,97 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyReadyCheck.h"
+
+namespace TrickyReadyCheck
+{
+	constexpr int32 WordBits = 32;
+}
+
+int32 FTrickyReadyCheck::AddPlayer()
+{
+	using namespace TrickyReadyCheck;
+
+	int32 WordIndex = ConnectedMask.IndexOfByPredicate([](const uint32 Word) { return Word != MAX_uint32; });
+
+	if (WordIndex == INDEX_NONE)
+	{
+		WordIndex = ConnectedMask.Add(0);
+		ReadyMask.Add(0);
+	}
+
+	const int32 Slot = WordIndex * WordBits + FMath::CountTrailingZeros(~ConnectedMask[WordIndex]);
+	SetBit(ConnectedMask, Slot, true);
+	++ConnectedNum;
+	return Slot;
+}
+
+bool FTrickyReadyCheck::RemovePlayer(const int32 Slot)
+{
+	if (!IsConnected(Slot))
+	{
+		return false;
+	}
+
+	SetReady(Slot, false);
+	SetBit(ConnectedMask, Slot, false);
+	--ConnectedNum;
+	return true;
+}
+
+bool FTrickyReadyCheck::SetReady(const int32 Slot, const bool bIsReady)
+{
+	if (!IsConnected(Slot) || IsReady(Slot) == bIsReady)
+	{
+		return false;
+	}
+
+	SetBit(ReadyMask, Slot, bIsReady);
+	ReadyNum += bIsReady ? 1 : -1;
+	return true;
+}
+
+void FTrickyReadyCheck::ResetReady()
+{
+	for (uint32& Word : ReadyMask)
+	{
+		Word = 0;
+	}
+
+	ReadyNum = 0;
+}
+
+int32 FTrickyReadyCheck::GetRequiredNum(const float Quorum) const
+{
+	return FMath::Max(FMath::CeilToInt32(ConnectedNum * FMath::Clamp(Quorum, 0.f, 1.f)), 1);
+}
+
+bool FTrickyReadyCheck::HasQuorum(const float Quorum) const
+{
+	return ConnectedNum > 0 && ReadyNum >= GetRequiredNum(Quorum);
+}
+
+bool FTrickyReadyCheck::operator==(const FTrickyReadyCheck& Other) const
+{
+	return ConnectedNum == Other.ConnectedNum
+		&& ReadyNum == Other.ReadyNum
+		&& ConnectedMask == Other.ConnectedMask
+		&& ReadyMask == Other.ReadyMask;
+}
+
+bool FTrickyReadyCheck::GetBit(const TArray<uint32>& Mask, const int32 Slot)
+{
+	using namespace TrickyReadyCheck;
+
+	const int32 WordIndex = Slot / WordBits;
+	return Slot >= 0 && Mask.IsValidIndex(WordIndex) && (Mask[WordIndex] & (1u << (Slot % WordBits))) != 0;
+}
+
+void FTrickyReadyCheck::SetBit(TArray<uint32>& Mask, const int32 Slot, const bool bValue)
+{
+	using namespace TrickyReadyCheck;
+
+	uint32& Word = Mask[Slot / WordBits];
+	const uint32 Bit = 1u << (Slot % WordBits);
+	Word = bValue ? Word | Bit : Word & ~Bit;
+}
@@ -0,0 +1,69 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyReadyCheckComponent.h"
+
+#include "TrickyGameModeBase.h"
+#include "TrickyGameStateBase.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerState.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+UTrickyReadyCheckComponent::UTrickyReadyCheckComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+}
+
+void UTrickyReadyCheckComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UTrickyReadyCheckComponent, PlayerSlot, Params);
+}
+
+void UTrickyReadyCheckComponent::SetReady(const bool bIsReady)
+{
+	if (bIsReadyRequested == bIsReady && IsReady() == bIsReady)
+	{
+		return;
+	}
+
+	bIsReadyRequested = bIsReady;
+	ServerSetReady(bIsReady);
+}
+
+bool UTrickyReadyCheckComponent::IsReady() const
+{
+	const UWorld* World = GetWorld();
+	const ATrickyGameStateBase* GameState = World ? World->GetGameState<ATrickyGameStateBase>() : nullptr;
+	return IsValid(GameState) && GameState->IsPlayerSlotReady(PlayerSlot);
+}
+
+void UTrickyReadyCheckComponent::SetPlayerSlot(const int32 Slot)
+{
+	if (PlayerSlot == Slot)
+	{
+		return;
+	}
+
+	PlayerSlot = Slot;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UTrickyReadyCheckComponent, PlayerSlot, this);
+}
+
+void UTrickyReadyCheckComponent::ServerSetReady_Implementation(const bool bIsReady)
+{
+	const APlayerState* PlayerState = GetOwner<APlayerState>();
+	ATrickyGameModeBase* GameMode = GetWorld()->GetAuthGameMode<ATrickyGameModeBase>();
+
+	if (!IsValid(PlayerState) || !IsValid(GameMode))
+	{
+		return;
+	}
+
+	bIsReadyRequested = bIsReady;
+	GameMode->SetPlayerReady(PlayerState->GetOwningController(), bIsReady);
+}
@@ -0,0 +1,198 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyRematchResettable.h"
+
+#include "Async/ParallelFor.h"
+#include "GameFramework/Actor.h"
+
+bool FTrickyRematchRegistry::Register(AActor* Actor)
+{
+	if (!IsValid(Actor) || !Actor->Implements<UTrickyRematchResettable>())
+	{
+		return false;
+	}
+
+	if (bIsResetting)
+	{
+		PendingChanges.Add({Actor, FObjectKey(Actor), true});
+		return true;
+	}
+
+	FClassBucket& Bucket = FindOrAddBucket(Actor->GetClass());
+
+	if (Bucket.ActorIndices.Contains(FObjectKey(Actor)))
+	{
+		return false;
+	}
+
+	Bucket.Add(Actor);
+	return true;
+}
+
+bool FTrickyRematchRegistry::Unregister(AActor* Actor)
+{
+	// The actor may already be marked as garbage when it's unregistered in EndPlay.
+	const int32* BucketIndex = Actor ? BucketIndices.Find(Actor->GetClass()) : nullptr;
+
+	if (!BucketIndex)
+	{
+		return false;
+	}
+
+	const FObjectKey ActorKey(Actor);
+
+	if (bIsResetting)
+	{
+		PendingChanges.Add({Actor, ActorKey, false});
+		return Buckets[*BucketIndex].ActorIndices.Contains(ActorKey);
+	}
+
+	return Buckets[*BucketIndex].Remove(ActorKey);
+}
+
+void FTrickyRematchRegistry::ResetAll()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTrickyRematchRegistry::ResetAll);
+
+	if (bIsResetting)
+	{
+		return;
+	}
+
+	bIsResetting = true;
+
+	for (FClassBucket& Bucket : Buckets)
+	{
+		ResetActors.Reset();
+		Resettables.Reset();
+
+		for (int32 Index = 0; Index < Bucket.Actors.Num(); ++Index)
+		{
+			if (Bucket.Actors[Index].IsValid())
+			{
+				ResetActors.Add(Bucket.Actors[Index]);
+			}
+			else
+			{
+				PendingChanges.Add({nullptr, Bucket.ActorKeys[Index], false});
+			}
+		}
+
+		// Blueprint implementations don't have a native interface, and they don't have native state either.
+		for (const TWeakObjectPtr<AActor>& Actor : ResetActors)
+		{
+			if (ITrickyRematchResettable* Resettable = Cast<ITrickyRematchResettable>(Actor.Get()))
+			{
+				Resettables.Add(Resettable);
+			}
+		}
+
+		const EParallelForFlags Flags = Bucket.bSupportsParallelReset
+			                                ? EParallelForFlags::None
+			                                : EParallelForFlags::ForceSingleThread;
+		ParallelFor(Resettables.Num(), [this](const int32 Index) { Resettables[Index]->ResetNativeState(); }, Flags);
+
+		// An actor reset earlier may destroy the following ones.
+		for (const TWeakObjectPtr<AActor>& Actor : ResetActors)
+		{
+			if (AActor* ResetActor = Actor.Get(); IsValid(ResetActor))
+			{
+				ITrickyRematchResettable::Execute_ResetForRematch(ResetActor);
+			}
+		}
+	}
+
+	ResetActors.Reset();
+	Resettables.Reset();
+	bIsResetting = false;
+	ApplyPendingChanges();
+}
+
+int32 FTrickyRematchRegistry::Num() const
+{
+	int32 ActorsNum = 0;
+
+	for (const FClassBucket& Bucket : Buckets)
+	{
+		ActorsNum += Bucket.Actors.Num();
+	}
+
+	return ActorsNum;
+}
+
+void FTrickyRematchRegistry::Reset()
+{
+	Buckets.Reset();
+	BucketIndices.Reset();
+	ResetActors.Reset();
+	Resettables.Reset();
+	PendingChanges.Reset();
+}
+
+FTrickyRematchRegistry::FClassBucket& FTrickyRematchRegistry::FindOrAddBucket(const UClass* Class)
+{
+	if (const int32* BucketIndex = BucketIndices.Find(Class))
+	{
+		return Buckets[*BucketIndex];
+	}
+
+	FClassBucket& Bucket = Buckets.AddDefaulted_GetRef();
+	Bucket.Class = Class;
+
+	const ITrickyRematchResettable* DefaultObject = Cast<ITrickyRematchResettable>(Class->GetDefaultObject());
+	Bucket.bSupportsParallelReset = DefaultObject && DefaultObject->SupportsParallelReset();
+	BucketIndices.Add(Class, Buckets.Num() - 1);
+	return Bucket;
+}
+
+void FTrickyRematchRegistry::ApplyPendingChanges()
+{
+	TArray<FPendingChange> Changes = MoveTemp(PendingChanges);
+	PendingChanges.Reset();
+
+	for (const FPendingChange& Change : Changes)
+	{
+		if (Change.bIsRegistered)
+		{
+			Register(Change.Actor.Get());
+			continue;
+		}
+
+		// Destroyed actors can't be resolved anymore, so they're looked up in every bucket.
+		for (FClassBucket& Bucket : Buckets)
+		{
+			if (Bucket.Remove(Change.ActorKey))
+			{
+				break;
+			}
+		}
+	}
+}
+
+void FTrickyRematchRegistry::FClassBucket::Add(AActor* Actor)
+{
+	const FObjectKey ActorKey(Actor);
+	ActorIndices.Add(ActorKey, Actors.Add(Actor));
+	ActorKeys.Add(ActorKey);
+}
+
+bool FTrickyRematchRegistry::FClassBucket::Remove(const FObjectKey& ActorKey)
+{
+	int32 Index = INDEX_NONE;
+
+	if (!ActorIndices.RemoveAndCopyValue(ActorKey, Index))
+	{
+		return false;
+	}
+
+	Actors.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	ActorKeys.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	if (ActorKeys.IsValidIndex(Index))
+	{
+		ActorIndices[ActorKeys[Index]] = Index;
+	}
+
+	return true;
+}
@@ -0,0 +1,47 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyServerTickRate.h"
+
+int32 FTrickyServerTickRates::GetTickRate(const ETrickyGameState State,
+                                          const EGameInactivityReason Reason,
+                                          const bool bHasPlayers) const
+{
+	switch (State)
+	{
+	case ETrickyGameState::Active:
+		return Active;
+
+	case ETrickyGameState::Finished:
+		return Finished;
+
+	default:
+		break;
+	}
+
+	if (!bHasPlayers && Hibernation > 0)
+	{
+		return FMath::Max(Hibernation, MinHibernationTickRate);
+	}
+
+	switch (Reason)
+	{
+	case EGameInactivityReason::Paused:
+		return Paused;
+
+	case EGameInactivityReason::Preparation:
+		return Preparation;
+
+	case EGameInactivityReason::Cutscene:
+		return Cutscene;
+
+	case EGameInactivityReason::Transition:
+		return Transition;
+
+	case EGameInactivityReason::Custom:
+		return Custom;
+
+	default:
+		return 0;
+	}
+}
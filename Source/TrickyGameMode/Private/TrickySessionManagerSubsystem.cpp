@@ -0,0 +1,438 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickySessionManagerSubsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+namespace TrickySessionManager
+{
+	static constexpr double NoDeadline = TNumericLimits<double>::Max();
+
+	static double GetDeadline(const FTrickyTimerStamp& Timer)
+	{
+		if (!Timer.IsActive() || Timer.IsPaused() || !Timer.IsLimited())
+		{
+			return NoDeadline;
+		}
+
+		return Timer.StartTime + Timer.PauseOffset + Timer.Duration;
+	}
+}
+
+void UTrickySessionManagerSubsystem::Deinitialize()
+{
+	Serials.Reset();
+	AliveSessions.Reset();
+	States.Reset();
+	LastStates.Reset();
+	InactivityReasons.Reset();
+	Results.Reset();
+	Settings.Reset();
+	PreparationTimers.Reset();
+	GameTimers.Reset();
+	Deadlines.Reset();
+	DeadlineQueue.Reset();
+	FreeIndices.Reset();
+	SessionsNum = 0;
+	ScheduledNum = 0;
+
+	Super::Deinitialize();
+}
+
+void UTrickySessionManagerSubsystem::Tick(float DeltaTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UTrickySessionManagerSubsystem::Tick);
+
+	Super::Tick(DeltaTime);
+
+	const double Now = GetTime();
+	DueSessions.Reset();
+
+	while (!DeadlineQueue.IsEmpty() && DeadlineQueue.HeapTop().Deadline <= Now)
+	{
+		FScheduledDeadline Scheduled;
+		DeadlineQueue.HeapPop(Scheduled, EAllowShrinking::No);
+		const int32 Index = Scheduled.Index;
+
+		if (AliveSessions[Index] && Serials[Index] == Scheduled.Serial && Deadlines[Index] == Scheduled.Deadline)
+		{
+			DueSessions.Add(Index);
+		}
+	}
+
+	for (const int32 Index : DueSessions)
+	{
+		// Listeners of previous sessions may have destroyed or rescheduled this one.
+		if (!AliveSessions[Index] || Deadlines[Index] > Now)
+		{
+			continue;
+		}
+
+		const FTrickySessionId SessionId = MakeId(Index);
+
+		// Mirrors HandlePreparationTimerFinished and HandleGameTimerFinished of the game mode.
+		if (PreparationTimers[Index].IsActive())
+		{
+			PreparationTimers[Index].Stop();
+			UpdateDeadline(Index);
+			StartGame(SessionId);
+		}
+		else if (GameTimers[Index].IsActive())
+		{
+			GameTimers[Index].Stop();
+			UpdateDeadline(Index);
+			FinishGame(SessionId, Settings[Index].DefaultTimeOverResult);
+		}
+	}
+}
+
+TStatId UTrickySessionManagerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTrickySessionManagerSubsystem, STATGROUP_Tickables);
+}
+
+ETickableTickType UTrickySessionManagerSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UTrickySessionManagerSubsystem::IsTickable() const
+{
+	return ScheduledNum > 0;
+}
+
+UTrickySessionManagerSubsystem* UTrickySessionManagerSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? World->GetSubsystem<UTrickySessionManagerSubsystem>() : nullptr;
+}
+
+FTrickySessionId UTrickySessionManagerSubsystem::CreateSession(const FTrickySessionSettings& SessionSettings)
+{
+	int32 Index = INDEX_NONE;
+
+	if (FreeIndices.IsEmpty())
+	{
+		Index = Serials.Add(0);
+		AliveSessions.Add(true);
+		States.AddDefaulted();
+		LastStates.AddDefaulted();
+		InactivityReasons.AddDefaulted();
+		Results.AddDefaulted();
+		Settings.AddDefaulted();
+		PreparationTimers.AddDefaulted();
+		GameTimers.AddDefaulted();
+		Deadlines.Add(TrickySessionManager::NoDeadline);
+	}
+	else
+	{
+		Index = FreeIndices.Pop(EAllowShrinking::No);
+		AliveSessions[Index] = true;
+	}
+
+	States[Index] = ETrickyGameState::Inactive;
+	LastStates[Index] = ETrickyGameState::Inactive;
+	InactivityReasons[Index] = SessionSettings.InitialInactivityReason;
+	Results[Index] = EGameResult::None;
+	Settings[Index] = SessionSettings;
+	PreparationTimers[Index].Stop();
+	GameTimers[Index].Stop();
+	++SessionsNum;
+
+	if (InactivityReasons[Index] == EGameInactivityReason::Preparation)
+	{
+		StartPreparationTimer(Index);
+	}
+
+	return MakeId(Index);
+}
+
+bool UTrickySessionManagerSubsystem::DestroySession(const FTrickySessionId& SessionId)
+{
+	const int32 Index = GetIndex(SessionId);
+
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	PreparationTimers[Index].Stop();
+	GameTimers[Index].Stop();
+	UpdateDeadline(Index);
+	AliveSessions[Index] = false;
+	++Serials[Index];
+	FreeIndices.Add(Index);
+	--SessionsNum;
+	return true;
+}
+
+bool UTrickySessionManagerSubsystem::StartGame(const FTrickySessionId& SessionId)
+{
+	const int32 Index = GetIndex(SessionId);
+
+	if (Index == INDEX_NONE || States[Index] == ETrickyGameState::Active)
+	{
+		return false;
+	}
+
+	FTrickyGameStateTransition Transition = BeginTransition(Index);
+	SetState(Index, ETrickyGameState::Active);
+	SetInactivityReason(Index, EGameInactivityReason::None);
+	FTrickyTimerStamp& GameTimer = GameTimers[Index];
+
+	if (!GameTimer.IsActive())
+	{
+		const FTrickySessionSettings& SessionSettings = Settings[Index];
+		GameTimer.Start(GetTime(), SessionSettings.bIsSessionTimeLimited ? SessionSettings.GameDuration : 0.f);
+		UpdateDeadline(Index);
+	}
+
+	EndTransition(Index, Transition);
+	return true;
+}
+
+bool UTrickySessionManagerSubsystem::FinishGame(const FTrickySessionId& SessionId, const EGameResult Result)
+{
+	const int32 Index = GetIndex(SessionId);
+
+	if (Index == INDEX_NONE || States[Index] == ETrickyGameState::Finished)
+	{
+		return false;
+	}
+
+	FTrickyGameStateTransition Transition = BeginTransition(Index);
+	Results[Index] = Result;
+	SetState(Index, ETrickyGameState::Finished);
+	EndTransition(Index, Transition);
+	return true;
+}
+
+bool UTrickySessionManagerSubsystem::StopGame(const FTrickySessionId& SessionId, const EGameInactivityReason Reason)
+{
+	const int32 Index = GetIndex(SessionId);
+
+	if (Index == INDEX_NONE || States[Index] == ETrickyGameState::Inactive)
+	{
+		return false;
+	}
+
+	FTrickyGameStateTransition Transition = BeginTransition(Index);
+	SetState(Index, ETrickyGameState::Inactive);
+	SetInactivityReason(Index, Reason);
+	EndTransition(Index, Transition);
+	return true;
+}
+
+bool UTrickySessionManagerSubsystem::ChangeInactivityReason(const FTrickySessionId& SessionId,
+                                                            const EGameInactivityReason Reason)
+{
+	const int32 Index = GetIndex(SessionId);
+
+	if (Index == INDEX_NONE || InactivityReasons[Index] == Reason)
+	{
+		return false;
+	}
+
+	FTrickyGameStateTransition Transition = BeginTransition(Index);
+	SetInactivityReason(Index, Reason);
+	EndTransition(Index, Transition);
+	return true;
+}
+
+bool UTrickySessionManagerSubsystem::StartPreparation(const FTrickySessionId& SessionId)
+{
+	const int32 Index = GetIndex(SessionId);
+
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// Like in TrickyGameModeBase, stopping a running or finished game doesn't start the preparation timer.
+	if (States[Index] != ETrickyGameState::Inactive)
+	{
+		return StopGame(SessionId, EGameInactivityReason::Preparation);
+	}
+
+	if (!ChangeInactivityReason(SessionId, EGameInactivityReason::Preparation))
+	{
+		return false;
+	}
+
+	StartPreparationTimer(Index);
+	return true;
+}
+
+bool UTrickySessionManagerSubsystem::StartCutscene(const FTrickySessionId& SessionId)
+{
+	return GetGameState(SessionId) != ETrickyGameState::Inactive
+		       ? StopGame(SessionId, EGameInactivityReason::Cutscene)
+		       : ChangeInactivityReason(SessionId, EGameInactivityReason::Cutscene);
+}
+
+bool UTrickySessionManagerSubsystem::StartTransition(const FTrickySessionId& SessionId)
+{
+	return GetGameState(SessionId) != ETrickyGameState::Inactive
+		       ? StopGame(SessionId, EGameInactivityReason::Transition)
+		       : ChangeInactivityReason(SessionId, EGameInactivityReason::Transition);
+}
+
+ETrickyGameState UTrickySessionManagerSubsystem::GetGameState(const FTrickySessionId& SessionId) const
+{
+	const int32 Index = GetIndex(SessionId);
+	return Index != INDEX_NONE ? States[Index] : ETrickyGameState::Inactive;
+}
+
+EGameResult UTrickySessionManagerSubsystem::GetGameResult(const FTrickySessionId& SessionId) const
+{
+	const int32 Index = GetIndex(SessionId);
+
+	if (Index == INDEX_NONE || States[Index] != ETrickyGameState::Finished)
+	{
+		return EGameResult::None;
+	}
+
+	return Results[Index];
+}
+
+EGameInactivityReason UTrickySessionManagerSubsystem::GetGameInactivityReason(const FTrickySessionId& SessionId) const
+{
+	const int32 Index = GetIndex(SessionId);
+
+	if (Index == INDEX_NONE || States[Index] != ETrickyGameState::Inactive)
+	{
+		return EGameInactivityReason::None;
+	}
+
+	return InactivityReasons[Index];
+}
+
+float UTrickySessionManagerSubsystem::GetGameElapsedTime(const FTrickySessionId& SessionId) const
+{
+	const int32 Index = GetIndex(SessionId);
+	return Index != INDEX_NONE ? static_cast<float>(GameTimers[Index].GetElapsed(GetTime())) : -1.f;
+}
+
+float UTrickySessionManagerSubsystem::GetGameRemainingTime(const FTrickySessionId& SessionId) const
+{
+	const int32 Index = GetIndex(SessionId);
+
+	if (Index == INDEX_NONE)
+	{
+		return -1.f;
+	}
+
+	const FTrickyTimerStamp& GameTimer = GameTimers[Index];
+	const double Now = GetTime();
+	return static_cast<float>(GameTimer.IsLimited() ? GameTimer.GetRemaining(Now) : GameTimer.GetElapsed(Now));
+}
+
+float UTrickySessionManagerSubsystem::GetPreparationRemainingTime(const FTrickySessionId& SessionId) const
+{
+	const int32 Index = GetIndex(SessionId);
+	return Index != INDEX_NONE ? static_cast<float>(PreparationTimers[Index].GetRemaining(GetTime())) : -1.f;
+}
+
+bool UTrickySessionManagerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UTrickySessionManagerSubsystem::GetIndex(const FTrickySessionId& SessionId) const
+{
+	const int32 Index = SessionId.Index;
+	const bool bIsValid = Serials.IsValidIndex(Index) && Serials[Index] == SessionId.Serial && AliveSessions[Index];
+	return bIsValid ? Index : INDEX_NONE;
+}
+
+double UTrickySessionManagerSubsystem::GetTime() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0;
+}
+
+void UTrickySessionManagerSubsystem::SetState(const int32 Index, const ETrickyGameState NewState)
+{
+	if (States[Index] == NewState)
+	{
+		return;
+	}
+
+	// Like in TrickyGameModeBase, state changes don't affect the running timers.
+	LastStates[Index] = States[Index];
+	States[Index] = NewState;
+}
+
+void UTrickySessionManagerSubsystem::SetInactivityReason(const int32 Index, const EGameInactivityReason NewReason)
+{
+	InactivityReasons[Index] = NewReason;
+}
+
+void UTrickySessionManagerSubsystem::StartPreparationTimer(const int32 Index)
+{
+	const float Duration = Settings[Index].PreparationDuration;
+
+	if (Duration <= 0.f || PreparationTimers[Index].IsActive())
+	{
+		return;
+	}
+
+	PreparationTimers[Index].Start(GetTime(), Duration);
+	UpdateDeadline(Index);
+}
+
+void UTrickySessionManagerSubsystem::UpdateDeadline(const int32 Index)
+{
+	const double NewDeadline = FMath::Min(TrickySessionManager::GetDeadline(PreparationTimers[Index]),
+	                                      TrickySessionManager::GetDeadline(GameTimers[Index]));
+	double& Deadline = Deadlines[Index];
+
+	if (Deadline == NewDeadline)
+	{
+		return;
+	}
+
+	ScheduledNum += (NewDeadline != TrickySessionManager::NoDeadline) - (Deadline != TrickySessionManager::NoDeadline);
+	Deadline = NewDeadline;
+
+	if (ScheduledNum == 0)
+	{
+		// Only stale entries are left.
+		DeadlineQueue.Reset();
+	}
+	else if (NewDeadline != TrickySessionManager::NoDeadline)
+	{
+		DeadlineQueue.HeapPush({NewDeadline, Index, Serials[Index]});
+	}
+}
+
+FTrickyGameStateTransition UTrickySessionManagerSubsystem::BeginTransition(const int32 Index) const
+{
+	FTrickyGameStateTransition Transition;
+	Transition.FromState = States[Index];
+	Transition.FromReason = InactivityReasons[Index];
+	return Transition;
+}
+
+void UTrickySessionManagerSubsystem::EndTransition(const int32 Index, FTrickyGameStateTransition& Transition)
+{
+	Transition.ToState = States[Index];
+	Transition.ToReason = InactivityReasons[Index];
+	Transition.Result = Results[Index];
+	Transition.Timestamp = GetTime();
+
+	if (Transition.FromState == Transition.ToState && Transition.FromReason == Transition.ToReason)
+	{
+		return;
+	}
+
+	const FTrickySessionId SessionId = MakeId(Index);
+	OnSessionTransitionNative.Broadcast(SessionId, Transition);
+
+	if (Transition.FromState != Transition.ToState)
+	{
+		OnSessionStateChanged.Broadcast(SessionId, Transition.ToState);
+	}
+}
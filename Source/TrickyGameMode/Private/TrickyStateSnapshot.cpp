@@ -0,0 +1,113 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyStateSnapshot.h"
+
+namespace TrickyStateSnapshot
+{
+	// Same layout as FTrickyReplicatedGameState::NetSerialize, the sequence takes the upper 32 bits.
+	constexpr uint32 StateBits = 2;
+	constexpr uint32 ReasonBits = 3;
+	constexpr uint32 ResultBits = 3;
+
+	constexpr uint64 StateMask = (1 << StateBits) - 1;
+	constexpr uint64 ReasonMask = (1 << ReasonBits) - 1;
+	constexpr uint64 ResultMask = (1 << ResultBits) - 1;
+
+	static void WriteTimer(std::atomic<double>* Values, const FTrickyTimerStamp& Timer)
+	{
+		Values[0].store(Timer.StartTime, std::memory_order_relaxed);
+		Values[1].store(Timer.Duration, std::memory_order_relaxed);
+		Values[2].store(Timer.PauseOffset, std::memory_order_relaxed);
+		Values[3].store(Timer.PauseStartTime, std::memory_order_relaxed);
+	}
+
+	static void ReadTimer(const std::atomic<double>* Values, FTrickyTimerStamp& OutTimer)
+	{
+		OutTimer.StartTime = Values[0].load(std::memory_order_relaxed);
+		OutTimer.Duration = static_cast<float>(Values[1].load(std::memory_order_relaxed));
+		OutTimer.PauseOffset = Values[2].load(std::memory_order_relaxed);
+		OutTimer.PauseStartTime = Values[3].load(std::memory_order_relaxed);
+	}
+}
+
+void FTrickyStateSnapshotPublisher::Publish(const FTrickyGameStateSnapshot& Snapshot)
+{
+	using namespace TrickyStateSnapshot;
+
+	check(IsInGameThread());
+
+	const uint32 Sequence = GetSequence() + 1;
+
+	// Readers which observe any of the new slot values also observe the previous word, and retry.
+	std::atomic_thread_fence(std::memory_order_release);
+
+	std::atomic<double>* Values = Slots[Sequence % SlotsNum].Values;
+	Values[0].store(Snapshot.Clock.PhaseStartTime, std::memory_order_relaxed);
+	WriteTimer(Values + 1, Snapshot.Clock.PreparationTimer);
+	WriteTimer(Values + 5, Snapshot.Clock.GameTimer);
+	Values[9].store(Snapshot.PublishWorldTime, std::memory_order_relaxed);
+	Values[10].store(Snapshot.PublishPlatformTime, std::memory_order_relaxed);
+
+	// Releases the slot values together with the word.
+	StateWord.store(PackState(Snapshot, Sequence), std::memory_order_release);
+}
+
+FTrickyGameStateSnapshot FTrickyStateSnapshotPublisher::ReadState() const
+{
+	FTrickyGameStateSnapshot Snapshot;
+	UnpackState(StateWord.load(std::memory_order_acquire), Snapshot);
+	return Snapshot;
+}
+
+FTrickyGameStateSnapshot FTrickyStateSnapshotPublisher::Read() const
+{
+	using namespace TrickyStateSnapshot;
+
+	FTrickyGameStateSnapshot Snapshot;
+	uint64 Word = StateWord.load(std::memory_order_acquire);
+
+	while (true)
+	{
+		UnpackState(Word, Snapshot);
+		const std::atomic<double>* Values = Slots[Snapshot.Sequence % SlotsNum].Values;
+		Snapshot.Clock.PhaseStartTime = Values[0].load(std::memory_order_relaxed);
+		ReadTimer(Values + 1, Snapshot.Clock.PreparationTimer);
+		ReadTimer(Values + 5, Snapshot.Clock.GameTimer);
+		Snapshot.PublishWorldTime = Values[9].load(std::memory_order_relaxed);
+		Snapshot.PublishPlatformTime = Values[10].load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const uint64 LatestWord = StateWord.load(std::memory_order_relaxed);
+
+		// The slot is rewritten only when the publisher is about to publish Sequence + SlotsNum.
+		if (static_cast<uint32>(LatestWord >> 32) - Snapshot.Sequence < SlotsNum - 1)
+		{
+			return Snapshot;
+		}
+
+		Word = LatestWord;
+	}
+}
+
+uint64 FTrickyStateSnapshotPublisher::PackState(const FTrickyGameStateSnapshot& Snapshot, const uint32 Sequence)
+{
+	using namespace TrickyStateSnapshot;
+
+	return static_cast<uint64>(Snapshot.State)
+		| (static_cast<uint64>(Snapshot.LastState) << StateBits)
+		| (static_cast<uint64>(Snapshot.InactivityReason) << (StateBits * 2))
+		| (static_cast<uint64>(Snapshot.Result) << (StateBits * 2 + ReasonBits))
+		| (static_cast<uint64>(Sequence) << 32);
+}
+
+void FTrickyStateSnapshotPublisher::UnpackState(const uint64 Word, FTrickyGameStateSnapshot& OutSnapshot)
+{
+	using namespace TrickyStateSnapshot;
+
+	OutSnapshot.State = static_cast<ETrickyGameState>(Word & StateMask);
+	OutSnapshot.LastState = static_cast<ETrickyGameState>((Word >> StateBits) & StateMask);
+	OutSnapshot.InactivityReason = static_cast<EGameInactivityReason>((Word >> (StateBits * 2)) & ReasonMask);
+	OutSnapshot.Result = static_cast<EGameResult>((Word >> (StateBits * 2 + ReasonBits)) & ResultMask);
+	OutSnapshot.Sequence = static_cast<uint32>(Word >> 32);
+}
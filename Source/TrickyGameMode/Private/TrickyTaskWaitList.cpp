@@ -0,0 +1,59 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyTaskWaitList.h"
+
+FTrickyTaskWaitList::~FTrickyTaskWaitList()
+{
+	// The listeners may already be destroyed with the owner, only release the waiting tasks.
+	for (const FWaitRef& Wait : Waits)
+	{
+		Wait->Unsubscribe.Reset();
+	}
+
+	CancelAll();
+}
+
+FTrickyTaskWaitList::FWaitRef FTrickyTaskWaitList::Add()
+{
+	check(IsInGameThread());
+	return Waits.Add_GetRef(MakeShared<FTrickyTaskWait, ESPMode::ThreadSafe>());
+}
+
+UE::Tasks::TTask<bool> FTrickyTaskWaitList::MakeTask(const FWaitRef& Wait)
+{
+	// The event orders the write of bIsResolved before the read, and the inline task costs no worker thread.
+	return UE::Tasks::Launch(TEXT("TrickyTaskWait"),
+	                         [Wait]() { return Wait->bIsResolved; },
+	                         UE::Tasks::Prerequisites(Wait->Event),
+	                         UE::Tasks::ETaskPriority::Normal,
+	                         UE::Tasks::EExtendedTaskPriority::Inline);
+}
+
+void FTrickyTaskWaitList::Complete(const FWaitRef& Wait, const bool bIsResolved)
+{
+	check(IsInGameThread());
+
+	if (Waits.RemoveSingleSwap(Wait, EAllowShrinking::No) == 0)
+	{
+		return;
+	}
+
+	if (Wait->Unsubscribe)
+	{
+		Wait->Unsubscribe();
+		Wait->Unsubscribe.Reset();
+	}
+
+	Wait->bIsResolved = bIsResolved;
+	Wait->Event.Trigger();
+}
+
+void FTrickyTaskWaitList::CancelAll()
+{
+	// Completing a wait may add a new one from a continuation running inline, so drain until empty.
+	while (!Waits.IsEmpty())
+	{
+		Complete(Waits.Last(), false);
+	}
+}
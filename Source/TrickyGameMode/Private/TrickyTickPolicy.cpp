@@ -0,0 +1,360 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyTickPolicy.h"
+
+#include "Components/ActorComponent.h"
+#include "GameFramework/Actor.h"
+
+ETrickyTickMode FTrickyTickPolicy::GetTickMode(const ETrickyGameState State, const EGameInactivityReason Reason) const
+{
+	switch (State)
+	{
+	case ETrickyGameState::Active:
+		return Active;
+
+	case ETrickyGameState::Finished:
+		return Finished;
+
+	default:
+		break;
+	}
+
+	switch (Reason)
+	{
+	case EGameInactivityReason::Paused:
+		return Paused;
+
+	case EGameInactivityReason::Preparation:
+		return Preparation;
+
+	case EGameInactivityReason::Cutscene:
+		return Cutscene;
+
+	case EGameInactivityReason::Transition:
+		return Transition;
+
+	case EGameInactivityReason::Custom:
+		return Custom;
+
+	default:
+		return ETrickyTickMode::Full;
+	}
+}
+
+bool FTrickyTickPolicy::operator==(const FTrickyTickPolicy& Other) const
+{
+	return Active == Other.Active
+		&& Preparation == Other.Preparation
+		&& Paused == Other.Paused
+		&& Cutscene == Other.Cutscene
+		&& Transition == Other.Transition
+		&& Custom == Other.Custom
+		&& Finished == Other.Finished
+		&& ReducedTickInterval == Other.ReducedTickInterval;
+}
+
+bool FTrickyTickPolicyRegistry::Register(UObject* Object, const FTrickyTickPolicy& Policy)
+{
+	if (!Object || (!Object->IsA<AActor>() && !Object->IsA<UActorComponent>()) || IsRegistered(Object))
+	{
+		return false;
+	}
+
+	FEntry Entry;
+	Entry.Object = Object;
+	AddEntry(Policy, MoveTemp(Entry));
+	return true;
+}
+
+FDelegateHandle FTrickyTickPolicyRegistry::Register(const FTrickyTickPolicy& Policy,
+                                                   FOnTickModeChangedSignature&& Delegate)
+{
+	if (!Delegate.IsBound())
+	{
+		return FDelegateHandle();
+	}
+
+	FEntry Entry;
+	Entry.Delegate = MoveTemp(Delegate);
+	const FDelegateHandle Handle = Entry.Delegate.GetHandle();
+	AddEntry(Policy, MoveTemp(Entry));
+	return Handle;
+}
+
+bool FTrickyTickPolicyRegistry::Unregister(const UObject* Object)
+{
+	if (!Object)
+	{
+		return false;
+	}
+
+	return RemoveEntry([Object](const FEntry& Entry) { return Entry.Object == Object; });
+}
+
+bool FTrickyTickPolicyRegistry::Unregister(const FDelegateHandle Handle)
+{
+	if (!Handle.IsValid())
+	{
+		return false;
+	}
+
+	return RemoveEntry([Handle](const FEntry& Entry) { return Entry.Delegate.GetHandle() == Handle; });
+}
+
+void FTrickyTickPolicyRegistry::Apply(const ETrickyGameState State, const EGameInactivityReason Reason)
+{
+	if (State == CurrentState && Reason == CurrentReason)
+	{
+		return;
+	}
+
+	CurrentState = State;
+	CurrentReason = Reason;
+
+	// A delegate changed the state, the latest state is applied after the current pass.
+	if (bIsApplying)
+	{
+		bIsApplyPending = true;
+		return;
+	}
+
+	bIsApplying = true;
+	ApplyCurrentState();
+	FinishApplying();
+}
+
+int32 FTrickyTickPolicyRegistry::Num() const
+{
+	int32 Num = PendingEntries.Num();
+
+	for (const FPolicyGroup& Group : Groups)
+	{
+		for (const FEntry& Entry : Group.Entries)
+		{
+			Num += Entry.bIsRemoved ? 0 : 1;
+		}
+	}
+
+	return Num;
+}
+
+void FTrickyTickPolicyRegistry::Reset()
+{
+	const bool bIsNested = bIsApplying;
+	bIsApplying = true;
+	PendingEntries.Reset();
+
+	for (FPolicyGroup& Group : Groups)
+	{
+		for (FEntry& Entry : Group.Entries)
+		{
+			if (Entry.bIsRemoved)
+			{
+				continue;
+			}
+
+			Entry.bIsRemoved = true;
+			ApplyToEntry(Entry, ETrickyTickMode::Full, Group.Policy.ReducedTickInterval);
+		}
+	}
+
+	if (!bIsNested)
+	{
+		FinishApplying();
+	}
+}
+
+FTrickyTickPolicyRegistry::FPolicyGroup& FTrickyTickPolicyRegistry::FindOrAddGroup(const FTrickyTickPolicy& Policy)
+{
+	FPolicyGroup* Group = Groups.FindByPredicate([&Policy](const FPolicyGroup& Other) { return Other.Policy == Policy; });
+
+	if (Group)
+	{
+		return *Group;
+	}
+
+	FPolicyGroup& NewGroup = Groups.AddDefaulted_GetRef();
+	NewGroup.Policy = Policy;
+	NewGroup.AppliedMode = Policy.GetTickMode(CurrentState, CurrentReason);
+	return NewGroup;
+}
+
+bool FTrickyTickPolicyRegistry::IsRegistered(const UObject* Object) const
+{
+	auto IsEntryOf = [Object](const FEntry& Entry) { return !Entry.bIsRemoved && Entry.Object == Object; };
+
+	for (const FPolicyGroup& Group : Groups)
+	{
+		if (Group.Entries.ContainsByPredicate(IsEntryOf))
+		{
+			return true;
+		}
+	}
+
+	return PendingEntries.ContainsByPredicate([&IsEntryOf](const FPendingEntry& Pending)
+	{
+		return IsEntryOf(Pending.Entry);
+	});
+}
+
+void FTrickyTickPolicyRegistry::AddEntry(const FTrickyTickPolicy& Policy, FEntry&& Entry)
+{
+	PendingEntries.Add({Policy, MoveTemp(Entry)});
+
+	if (!bIsApplying)
+	{
+		bIsApplying = true;
+		FinishApplying();
+	}
+}
+
+bool FTrickyTickPolicyRegistry::RemoveEntry(TFunctionRef<bool(const FEntry&)> Predicate)
+{
+	// Pending entries haven't been applied yet, so there is nothing to restore.
+	const int32 PendingIndex = PendingEntries.IndexOfByPredicate([&Predicate](const FPendingEntry& Pending)
+	{
+		return Predicate(Pending.Entry);
+	});
+
+	if (PendingIndex != INDEX_NONE)
+	{
+		PendingEntries.RemoveAt(PendingIndex);
+		return true;
+	}
+
+	for (FPolicyGroup& Group : Groups)
+	{
+		const int32 Index = Group.Entries.IndexOfByPredicate([&Predicate](const FEntry& Entry)
+		{
+			return !Entry.bIsRemoved && Predicate(Entry);
+		});
+
+		if (Index == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const bool bIsNested = bIsApplying;
+		bIsApplying = true;
+		Group.Entries[Index].bIsRemoved = true;
+		ApplyToEntry(Group.Entries[Index], ETrickyTickMode::Full, Group.Policy.ReducedTickInterval);
+
+		if (!bIsNested)
+		{
+			FinishApplying();
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+void FTrickyTickPolicyRegistry::ApplyCurrentState()
+{
+	for (FPolicyGroup& Group : Groups)
+	{
+		const ETrickyTickMode TickMode = Group.Policy.GetTickMode(CurrentState, CurrentReason);
+
+		if (TickMode == Group.AppliedMode)
+		{
+			continue;
+		}
+
+		Group.AppliedMode = TickMode;
+
+		for (FEntry& Entry : Group.Entries)
+		{
+			if (!Entry.bIsRemoved && !ApplyToEntry(Entry, TickMode, Group.Policy.ReducedTickInterval))
+			{
+				Entry.bIsRemoved = true;
+			}
+		}
+	}
+}
+
+void FTrickyTickPolicyRegistry::FinishApplying()
+{
+	while (bIsApplyPending || !PendingEntries.IsEmpty())
+	{
+		if (bIsApplyPending)
+		{
+			bIsApplyPending = false;
+			ApplyCurrentState();
+			continue;
+		}
+
+		FPendingEntry Pending = MoveTemp(PendingEntries[0]);
+		PendingEntries.RemoveAt(0);
+
+		FPolicyGroup& Group = FindOrAddGroup(Pending.Policy);
+		FEntry& Entry = Group.Entries.Add_GetRef(MoveTemp(Pending.Entry));
+
+		if (!ApplyToEntry(Entry, Group.AppliedMode, Group.Policy.ReducedTickInterval))
+		{
+			Entry.bIsRemoved = true;
+		}
+	}
+
+	for (FPolicyGroup& Group : Groups)
+	{
+		Group.Entries.RemoveAllSwap([](const FEntry& Entry) { return Entry.bIsRemoved; }, EAllowShrinking::No);
+	}
+
+	Groups.RemoveAllSwap([](const FPolicyGroup& Group) { return Group.Entries.IsEmpty(); }, EAllowShrinking::No);
+
+	bIsApplying = false;
+}
+
+bool FTrickyTickPolicyRegistry::ApplyToEntry(FEntry& Entry,
+                                            const ETrickyTickMode TickMode,
+                                            const float ReducedTickInterval)
+{
+	if (Entry.Delegate.IsBound())
+	{
+		Entry.Delegate.Execute(TickMode, TickMode == ETrickyTickMode::Reduced ? ReducedTickInterval : 0.f);
+		return true;
+	}
+
+	UObject* Object = Entry.Object.Get();
+	AActor* Actor = Cast<AActor>(Object);
+	UActorComponent* Component = Actor ? nullptr : Cast<UActorComponent>(Object);
+
+	if (!Actor && !Component)
+	{
+		return false;
+	}
+
+	// The settings are left untouched in the Full mode, so the changes made by the owner are kept.
+	if (TickMode == ETrickyTickMode::Full && !Entry.bIsThrottled)
+	{
+		return true;
+	}
+
+	if (!Entry.bIsThrottled)
+	{
+		Entry.FullTickInterval = Actor ? Actor->GetActorTickInterval() : Component->GetComponentTickInterval();
+		Entry.bIsTickEnabled = Actor ? Actor->IsActorTickEnabled() : Component->IsComponentTickEnabled();
+	}
+
+	Entry.bIsThrottled = TickMode != ETrickyTickMode::Full;
+
+	const bool bIsEnabled = Entry.bIsTickEnabled && TickMode != ETrickyTickMode::Disabled;
+	const float Interval = TickMode == ETrickyTickMode::Reduced
+		                       ? FMath::Max(Entry.FullTickInterval, ReducedTickInterval)
+		                       : Entry.FullTickInterval;
+
+	if (Actor)
+	{
+		Actor->SetActorTickInterval(Interval);
+		Actor->SetActorTickEnabled(bIsEnabled);
+	}
+	else
+	{
+		Component->SetComponentTickInterval(Interval);
+		Component->SetComponentTickEnabled(bIsEnabled);
+	}
+
+	return true;
+}
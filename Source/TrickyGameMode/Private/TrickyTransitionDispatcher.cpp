@@ -0,0 +1,232 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyTransitionDispatcher.h"
+
+#include "Algo/BinarySearch.h"
+
+FDelegateHandle FTrickyTransitionDispatcher::Subscribe(const FTrickyTransitionFilter& Filter,
+                                                       FOnGameStateTransitionSignature::FDelegate&& Delegate,
+                                                       const FTrickyTransitionListenerOptions& Options)
+{
+	if (!Delegate.IsBound())
+	{
+		return FDelegateHandle();
+	}
+
+	FListener Listener;
+	Listener.Handle = FDelegateHandle(FDelegateHandle::GenerateNewHandle);
+	Listener.ReasonMask = Filter.ReasonMask;
+	Listener.Priority = Options.Priority;
+	Listener.bMayDefer = Options.bMayDefer;
+	Listener.Delegate = MoveTemp(Delegate);
+
+	const FDelegateHandle Handle = Listener.Handle;
+
+	if (DispatchDepth > 0)
+	{
+		FPendingListener& Pending = PendingListeners.AddDefaulted_GetRef();
+		Pending.Filter = Filter;
+		Pending.Listener = MoveTemp(Listener);
+		return Handle;
+	}
+
+	AddListener(Filter, Listener);
+	return Handle;
+}
+
+bool FTrickyTransitionDispatcher::Unsubscribe(const FDelegateHandle Handle)
+{
+	if (!Handle.IsValid())
+	{
+		return false;
+	}
+
+	for (int32 Index = DeferredHead; Index < DeferredCalls.Num(); ++Index)
+	{
+		if (DeferredCalls[Index].Handle == Handle)
+		{
+			DeferredCalls[Index].Delegate.Unbind();
+		}
+	}
+
+	const int32 RemovedNum = PendingListeners.RemoveAll([&Handle](const FPendingListener& Pending)
+	{
+		return Pending.Listener.Handle == Handle;
+	});
+
+	if (RemovedNum > 0)
+	{
+		return true;
+	}
+
+	bool bIsFound = false;
+
+	for (TArray<FListener>& Listeners : Edges)
+	{
+		for (int32 Index = Listeners.Num() - 1; Index >= 0; --Index)
+		{
+			if (Listeners[Index].Handle != Handle)
+			{
+				continue;
+			}
+
+			bIsFound = true;
+
+			// The arrays can't be changed while they're iterated, so listeners are only unbound during a dispatch.
+			if (DispatchDepth > 0)
+			{
+				Listeners[Index].Delegate.Unbind();
+				bHasUnboundListeners = true;
+			}
+			else
+			{
+				Listeners.RemoveAt(Index);
+			}
+		}
+	}
+
+	return bIsFound;
+}
+
+void FTrickyTransitionDispatcher::Dispatch(const FTrickyGameStateTransition& Transition)
+{
+	const TArray<FListener>& Listeners = Edges[GetEdgeIndex(Transition.FromState, Transition.ToState)];
+
+	if (Listeners.IsEmpty())
+	{
+		return;
+	}
+
+	const int32 ReasonBit = FTrickyTransitionFilter::ToMask(Transition.GetInactivityReason());
+	++DispatchDepth;
+
+	for (const FListener& Listener : Listeners)
+	{
+		if (!(Listener.ReasonMask & ReasonBit))
+		{
+			continue;
+		}
+
+		if (Listener.bMayDefer)
+		{
+			FDeferredCall& DeferredCall = DeferredCalls.AddDefaulted_GetRef();
+			DeferredCall.Handle = Listener.Handle;
+			DeferredCall.Delegate = Listener.Delegate;
+			DeferredCall.Transition = Transition;
+			continue;
+		}
+
+		Listener.Delegate.ExecuteIfBound(Transition);
+	}
+
+	--DispatchDepth;
+	FlushPendingChanges();
+}
+
+bool FTrickyTransitionDispatcher::DispatchDeferred(const double BudgetSeconds)
+{
+	if (!HasDeferredListeners())
+	{
+		return false;
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + BudgetSeconds;
+	++DispatchDepth;
+
+	do
+	{
+		// The queue can grow while the listener is invoked, so the call is moved out of it first.
+		const FDeferredCall DeferredCall = MoveTemp(DeferredCalls[DeferredHead++]);
+		DeferredCall.Delegate.ExecuteIfBound(DeferredCall.Transition);
+	}
+	while (HasDeferredListeners() && FPlatformTime::Seconds() < EndTime);
+
+	--DispatchDepth;
+
+	if (!HasDeferredListeners())
+	{
+		DeferredCalls.Reset();
+		DeferredHead = 0;
+	}
+	else if (DeferredHead >= DeferredCalls.Num() / 2)
+	{
+		DeferredCalls.RemoveAt(0, DeferredHead, EAllowShrinking::No);
+		DeferredHead = 0;
+	}
+
+	FlushPendingChanges();
+	return HasDeferredListeners();
+}
+
+void FTrickyTransitionDispatcher::Reset()
+{
+	check(DispatchDepth == 0);
+
+	for (TArray<FListener>& Listeners : Edges)
+	{
+		Listeners.Reset();
+	}
+
+	PendingListeners.Reset();
+	DeferredCalls.Reset();
+	DeferredHead = 0;
+	bHasUnboundListeners = false;
+}
+
+void FTrickyTransitionDispatcher::AddListener(const FTrickyTransitionFilter& Filter, const FListener& Listener)
+{
+	for (int32 From = 0; From < StatesNum; ++From)
+	{
+		if (!(Filter.FromStateMask & (1 << From)))
+		{
+			continue;
+		}
+
+		for (int32 To = 0; To < StatesNum; ++To)
+		{
+			if (!(Filter.ToStateMask & (1 << To)))
+			{
+				continue;
+			}
+
+			// Listeners are kept sorted by priority, listeners with equal priority keep the subscription order.
+			TArray<FListener>& Listeners = Edges[From * StatesNum + To];
+			const int32 Index = Algo::UpperBoundBy(Listeners,
+			                                       Listener.Priority,
+			                                       [](const FListener& Other) { return Other.Priority; },
+			                                       [](const int32 A, const int32 B) { return A > B; });
+			Listeners.Insert(Listener, Index);
+		}
+	}
+}
+
+void FTrickyTransitionDispatcher::FlushPendingChanges()
+{
+	if (DispatchDepth > 0)
+	{
+		return;
+	}
+
+	if (bHasUnboundListeners)
+	{
+		for (TArray<FListener>& Listeners : Edges)
+		{
+			Listeners.RemoveAll([](const FListener& Listener) { return !Listener.Delegate.IsBound(); });
+		}
+
+		bHasUnboundListeners = false;
+	}
+
+	if (PendingListeners.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<FPendingListener> ListenersToAdd = MoveTemp(PendingListeners);
+
+	for (const FPendingListener& Pending : ListenersToAdd)
+	{
+		AddListener(Pending.Filter, Pending.Listener);
+	}
+}
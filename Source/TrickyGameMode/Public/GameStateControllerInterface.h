@@ -46,6 +46,44 @@ enum class EGameInactivityReason : uint8
 	Custom
 };
 
+namespace TrickyGameMode
+{
+	/**
+	 * Names of the enum values. They must be kept in the same order as the enums.
+	 */
+	inline constexpr const TCHAR* GameStateNames[] = {TEXT("Inactive"), TEXT("Active"), TEXT("Finished")};
+
+	inline constexpr const TCHAR* GameResultNames[] = {
+		TEXT("None"), TEXT("Win"), TEXT("Loose"), TEXT("Draw"), TEXT("Custom")
+	};
+
+	inline constexpr const TCHAR* InactivityReasonNames[] = {
+		TEXT("None"), TEXT("Paused"), TEXT("Preparation"), TEXT("Cutscene"), TEXT("Transition"), TEXT("Custom")
+	};
+
+	template <typename EnumType, SIZE_T NamesNum>
+	constexpr const TCHAR* GetEnumName(const TCHAR* const (&Names)[NamesNum], const EnumType Value)
+	{
+		const SIZE_T Index = static_cast<SIZE_T>(Value);
+		return Index < NamesNum ? Names[Index] : TEXT("Invalid");
+	}
+}
+
+FORCEINLINE const TCHAR* LexToString(const ETrickyGameState State)
+{
+	return TrickyGameMode::GetEnumName(TrickyGameMode::GameStateNames, State);
+}
+
+FORCEINLINE const TCHAR* LexToString(const EGameResult Result)
+{
+	return TrickyGameMode::GetEnumName(TrickyGameMode::GameResultNames, Result);
+}
+
+FORCEINLINE const TCHAR* LexToString(const EGameInactivityReason Reason)
+{
+	return TrickyGameMode::GetEnumName(TrickyGameMode::InactivityReasonNames, Reason);
+}
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnGameStateChangedDynamicSignature, const ETrickyGameState, NewState);
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnGameStartedDynamicSignature);
@@ -57,6 +95,48 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnGameStoppedDynamicSignature, cons
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnGameInactivityReasonChangedDynamicSignature,
                                             const EGameInactivityReason, InactivityReason);
 
+/**
+ * Describes a single transition of the game state machine.
+ */
+USTRUCT(BlueprintType)
+struct TRICKYGAMEMODE_API FTrickyGameStateTransition
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=GameState)
+	ETrickyGameState FromState = ETrickyGameState::Inactive;
+
+	UPROPERTY(BlueprintReadOnly, Category=GameState)
+	ETrickyGameState ToState = ETrickyGameState::Inactive;
+
+	UPROPERTY(BlueprintReadOnly, Category=GameState)
+	EGameInactivityReason FromReason = EGameInactivityReason::None;
+
+	UPROPERTY(BlueprintReadOnly, Category=GameState)
+	EGameInactivityReason ToReason = EGameInactivityReason::None;
+
+	UPROPERTY(BlueprintReadOnly, Category=GameState)
+	EGameResult Result = EGameResult::None;
+
+	/**
+	 * World time when the transition happened.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category=GameState)
+	double Timestamp = 0.0;
+
+	/**
+	 * Returns the inactivity reason of the inactive side of the transition.
+	 */
+	FORCEINLINE EGameInactivityReason GetInactivityReason() const
+	{
+		return ToState == ETrickyGameState::Inactive ? ToReason : FromReason;
+	}
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnGameStateTransitionSignature, const FTrickyGameStateTransition& /*Transition*/);
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnGameTimerChangedSignature, float /*Time*/);
+
 // This class does not need to be modified.
 UINTERFACE(MinimalAPI, Blueprintable)
 class UGameStateControllerInterface : public UInterface
@@ -195,3 +275,78 @@ public:
 
 	virtual float GetGameRemainingTime_Implementation() const;
 };
+
+/**
+ * Calls GameStateControllerInterface functions of an object.
+ * Functions which aren't overridden in Blueprint are called directly through their _Implementation,
+ * skipping the reflection system. The overrides are detected once when the caller is created.
+ */
+class TRICKYGAMEMODE_API FGameStateControllerCaller
+{
+public:
+	FGameStateControllerCaller() = default;
+
+	explicit FGameStateControllerCaller(UObject* InObject);
+
+	FORCEINLINE bool IsValid() const { return Object != nullptr; }
+
+	FORCEINLINE UObject* GetObject() const { return Object; }
+
+	bool StartGame() const;
+
+	bool FinishGame(const EGameResult Result) const;
+
+	bool StopGame(const EGameInactivityReason Reason) const;
+
+	bool ChangeInactivityReason(const EGameInactivityReason NewInactivityReason) const;
+
+	bool StartPreparation() const;
+
+	bool StartCutscene() const;
+
+	bool StartTransition() const;
+
+	ETrickyGameState GetGameState() const;
+
+	EGameResult GetGameResult() const;
+
+	EGameInactivityReason GetGameInactivityReason() const;
+
+	float GetGameElapsedTime() const;
+
+	float GetGameRemainingTime() const;
+
+private:
+	enum class EFunction : uint16
+	{
+		StartGame = 1 << 0,
+		FinishGame = 1 << 1,
+		StopGame = 1 << 2,
+		ChangeInactivityReason = 1 << 3,
+		StartPreparation = 1 << 4,
+		StartCutscene = 1 << 5,
+		StartTransition = 1 << 6,
+		GetGameState = 1 << 7,
+		GetGameResult = 1 << 8,
+		GetGameInactivityReason = 1 << 9,
+		GetGameElapsedTime = 1 << 10,
+		GetGameRemainingTime = 1 << 11
+	};
+
+	UObject* Object = nullptr;
+
+	/**
+	 * Native interface of the object, nullptr if the interface is implemented only in Blueprint.
+	 */
+	IGameStateControllerInterface* NativeInterface = nullptr;
+
+	/**
+	 * Functions overridden in Blueprint.
+	 */
+	uint16 ScriptFunctions = 0;
+
+	FORCEINLINE bool IsNative(const EFunction Function) const
+	{
+		return NativeInterface && !(ScriptFunctions & static_cast<uint16>(Function));
+	}
+};
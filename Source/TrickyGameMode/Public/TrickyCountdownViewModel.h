@@ -0,0 +1,172 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FieldNotificationDelegate.h"
+#include "GameStateControllerInterface.h"
+#include "INotifyFieldValueChanged.h"
+#include "TimerManager.h"
+#include "TrickyCountdownViewModel.generated.h"
+
+class ATrickyGameStateBase;
+struct FTrickyTimerStamp;
+
+UENUM(BlueprintType)
+enum class ETrickyCountdownGranularity : uint8
+{
+	Seconds,
+	Tenths,
+	MinutesSeconds
+};
+
+/**
+ * A view model of TrickyGameStateBase for UMG bindings.
+ * Publishes the state, inactivity reason, result and timers as field notifications.
+ * The timers are published only when the displayed value changes at the chosen granularity,
+ * so bound widgets don't need to tick.
+ * Implements INotifyFieldValueChanged directly, so it works with UMG and MVVM bindings without depending on MVVM.
+ */
+UCLASS(Blueprintable, BlueprintType)
+class TRICKYGAMEMODE_API UTrickyCountdownViewModel : public UObject, public INotifyFieldValueChanged
+{
+	GENERATED_BODY()
+
+public:
+	virtual FDelegateHandle AddFieldValueChangedDelegate(UE::FieldNotification::FFieldId InFieldId,
+	                                                     FFieldValueChangedDelegate InNewDelegate) override;
+
+	virtual bool RemoveFieldValueChangedDelegate(UE::FieldNotification::FFieldId InFieldId,
+	                                             FDelegateHandle InHandle) override;
+
+	virtual int32 RemoveAllFieldValueChangedDelegates(FDelegateUserObjectConst InUserObject) override;
+
+	virtual int32 RemoveAllFieldValueChangedDelegates(UE::FieldNotification::FFieldId InFieldId,
+	                                                  FDelegateUserObjectConst InUserObject) override;
+
+	virtual void BroadcastFieldValueChanged(UE::FieldNotification::FFieldId InFieldId) override;
+
+	/**
+	 * Binds the view model to the game state, it's called by the game state itself.
+	 */
+	void Initialize(ATrickyGameStateBase* InGameState);
+
+	void Deinitialize();
+
+	/**
+	 * Updates all fields from the game state and schedules the next timer update.
+	 */
+	void Refresh();
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE ETrickyCountdownGranularity GetGranularity() const { return Granularity; }
+
+	UFUNCTION(BlueprintSetter, Category=GameState)
+	void SetGranularity(const ETrickyCountdownGranularity Value);
+
+	ETrickyGameState GetGameState() const { return GameState; }
+
+	EGameInactivityReason GetInactivityReason() const { return InactivityReason; }
+
+	EGameResult GetGameResult() const { return GameResult; }
+
+	float GetGameElapsedTime() const { return GameElapsedTime; }
+
+	float GetGameRemainingTime() const { return GameRemainingTime; }
+
+	FText GetGameRemainingText() const { return GameRemainingText; }
+
+	float GetPreparationElapsedTime() const { return PreparationElapsedTime; }
+
+	float GetPreparationRemainingTime() const { return PreparationRemainingTime; }
+
+	FText GetPreparationRemainingText() const { return PreparationRemainingText; }
+
+private:
+	/**
+	 * Defines how often the timer fields change: every second, every tenth of a second,
+	 * or every second formatted as mm:ss.
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		BlueprintGetter=GetGranularity,
+		BlueprintSetter=SetGranularity,
+		Category=GameState)
+	ETrickyCountdownGranularity Granularity = ETrickyCountdownGranularity::Seconds;
+
+	UPROPERTY(BlueprintReadOnly, FieldNotify, Getter, Category=GameState, meta=(AllowPrivateAccess="true"))
+	ETrickyGameState GameState = ETrickyGameState::Inactive;
+
+	UPROPERTY(BlueprintReadOnly, FieldNotify, Getter, Category=GameState, meta=(AllowPrivateAccess="true"))
+	EGameInactivityReason InactivityReason = EGameInactivityReason::None;
+
+	UPROPERTY(BlueprintReadOnly, FieldNotify, Getter, Category=GameState, meta=(AllowPrivateAccess="true"))
+	EGameResult GameResult = EGameResult::None;
+
+	/**
+	 * Elapsed game time rounded down to the granularity, -1 if the game timer isn't active.
+	 */
+	UPROPERTY(BlueprintReadOnly, FieldNotify, Getter, Category=GameState, meta=(AllowPrivateAccess="true"))
+	float GameElapsedTime = -1.f;
+
+	/**
+	 * Remaining game time rounded up to the granularity. Elapsed time if the session isn't time limited.
+	 */
+	UPROPERTY(BlueprintReadOnly, FieldNotify, Getter, Category=GameState, meta=(AllowPrivateAccess="true"))
+	float GameRemainingTime = -1.f;
+
+	UPROPERTY(BlueprintReadOnly, FieldNotify, Getter, Category=GameState, meta=(AllowPrivateAccess="true"))
+	FText GameRemainingText;
+
+	UPROPERTY(BlueprintReadOnly, FieldNotify, Getter, Category=GameState, meta=(AllowPrivateAccess="true"))
+	float PreparationElapsedTime = -1.f;
+
+	UPROPERTY(BlueprintReadOnly, FieldNotify, Getter, Category=GameState, meta=(AllowPrivateAccess="true"))
+	float PreparationRemainingTime = -1.f;
+
+	UPROPERTY(BlueprintReadOnly, FieldNotify, Getter, Category=GameState, meta=(AllowPrivateAccess="true"))
+	FText PreparationRemainingText;
+
+	TWeakObjectPtr<ATrickyGameStateBase> OwningGameState;
+
+	UE::FieldNotification::FFieldMulticastDelegate FieldDelegates;
+
+	FTimerHandle UpdateTimerHandle;
+
+	struct FTimerDisplay
+	{
+		float ElapsedTime = -1.f;
+
+		float RemainingTime = -1.f;
+
+		/**
+		 * Time until one of the displayed values changes, negative if they won't change.
+		 */
+		double NextUpdateDelay = -1.0;
+	};
+
+	double GetStep() const;
+
+	FTimerDisplay MakeTimerDisplay(const FTrickyTimerStamp& Stamp, const double Now) const;
+
+	FText FormatTime(const float Time) const;
+
+	void UpdateTimers();
+
+	/**
+	 * Sets the field and notifies the bound widgets if the value changed.
+	 *
+	 * @return True if the value changed.
+	 */
+	template<typename ValueType>
+	bool SetFieldValue(ValueType& Field, const ValueType& NewValue, const UE::FieldNotification::FFieldId FieldId)
+	{
+		if (Field == NewValue)
+		{
+			return false;
+		}
+
+		Field = NewValue;
+		BroadcastFieldValueChanged(FieldId);
+		return true;
+	}
+};
@@ -4,9 +4,20 @@
 
 #include "CoreMinimal.h"
 #include "GameStateControllerInterface.h"
+#include "TrickyParticipantRegistry.h"
+#include "TrickyReadyCheck.h"
+#include "TrickyServerTickRate.h"
+#include "TrickySessionClock.h"
+#include "TrickyStateSnapshot.h"
+#include "TrickyTaskWaitList.h"
+#include "TrickyTickPolicy.h"
+#include "TrickyTransitionDispatcher.h"
+#include "Containers/Ticker.h"
 #include "GameFramework/GameModeBase.h"
 #include "TrickyGameModeBase.generated.h"
 
+struct FTrickyTimerMilestone;
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPreparationTimerStartedDynamicSignature, float, Duration);
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPreparationTimerStoppedDynamicSignature, float, ElapsedTime);
@@ -15,6 +26,43 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnGameTimerStartedDynamicSignature,
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnGameTimerStoppedDynamicSignature, float, ElapsedTime);
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnPlayerFinishedDynamicSignature,
+                                             AController*,
+                                             Player,
+                                             EGameResult,
+                                             Result);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnRematchStartedDynamicSignature);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnRoundStartedDynamicSignature, int32, Round);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnRoundFinishedDynamicSignature, int32, Round, EGameResult, Result);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnTeamFinishedDynamicSignature, int32, Team, EGameResult, Result);
+
+/**
+ * Native events queued during a transition and triggered when the outermost transition ends.
+ */
+enum class ETrickyNativeTransitionEvent : uint8
+{
+	GameStarted,
+	GameFinished,
+	GameStopped,
+	RematchStarted
+};
+
+/**
+ * Defines when the game finishes automatically depending on the states of the players and teams.
+ */
+UENUM(BlueprintType)
+enum class ETrickyAutoFinishCondition : uint8
+{
+	None,
+	LastPlayerStanding,
+	LastTeamStanding,
+	AllPlayersFinished
+};
+
 /**
  * A custom game mode base class that provides extensive functionality
  * to control the game state and gameplay flow. 
@@ -25,8 +73,18 @@ class TRICKYGAMEMODE_API ATrickyGameModeBase : public AGameModeBase, public IGam
 	GENERATED_BODY()
 
 public:
+	ATrickyGameModeBase();
+
+	virtual void PostInitProperties() override;
+
 	virtual void StartPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	virtual void Logout(AController* Exiting) override;
+
 	virtual bool SetPause(APlayerController* PC, FCanUnpause CanUnpauseDelegate = FCanUnpause()) override;
 
 	virtual bool ClearPause() override;
@@ -87,6 +145,273 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FOnGameTimerStoppedDynamicSignature OnGameTimerStopped;
 
+	/**
+	 * Triggered when a player finished, e.g. was eliminated, while the game goes on.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnPlayerFinishedDynamicSignature OnPlayerFinished;
+
+	/**
+	 * Triggered when the last alive player of a team finished.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnTeamFinishedDynamicSignature OnTeamFinished;
+
+	/**
+	 * Triggered when a rematch started and the game returned to its initial state.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnRematchStartedDynamicSignature OnRematchStarted;
+
+	/**
+	 * Triggered when a new round started.
+	 * @warning called only if bIsRoundBased == true
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnRoundStartedDynamicSignature OnRoundStarted;
+
+	/**
+	 * Triggered when a round finished.
+	 * @warning called only if bIsRoundBased == true
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnRoundFinishedDynamicSignature OnRoundFinished;
+
+	/**
+	 * Native counterparts of the events above, they don't go through the reflection system.
+	 * Transition events are triggered once the whole transition is done, e.g. after both the state and
+	 * the inactivity reason were changed by StopGame, in the same order as the dynamic events:
+	 * OnGameStateChangedNative, OnInactivityReasonChangedNative, then OnGameStartedNative, OnGameFinishedNative,
+	 * OnGameStoppedNative or OnRematchStartedNative.
+	 */
+	FOnGameStateTransitionSignature OnGameStateChangedNative;
+
+	FOnGameStateTransitionSignature OnGameStartedNative;
+
+	FOnGameStateTransitionSignature OnGameFinishedNative;
+
+	FOnGameStateTransitionSignature OnGameStoppedNative;
+
+	FOnGameStateTransitionSignature OnInactivityReasonChangedNative;
+
+	FOnGameStateTransitionSignature OnRematchStartedNative;
+
+	FOnGameTimerChangedSignature OnPreparationTimerStartedNative;
+
+	FOnGameTimerChangedSignature OnPreparationTimerStoppedNative;
+
+	FOnGameTimerChangedSignature OnGameTimerStartedNative;
+
+	FOnGameTimerChangedSignature OnGameTimerStoppedNative;
+
+	/**
+	 * Returns the last completed transition of the game state machine.
+	 */
+	FORCEINLINE const FTrickyGameStateTransition& GetLastTransition() const { return LastTransition; }
+
+	FORCEINLINE const FTrickySessionClock& GetSessionClock() const { return SessionClock; }
+
+	/**
+	 * Returns the publisher of the state snapshots which can be read from any thread.
+	 * Keep the reference instead of the game mode to read the state outside the game thread.
+	 */
+	FORCEINLINE TSharedRef<const FTrickyStateSnapshotPublisher, ESPMode::ThreadSafe> GetStateSnapshotPublisher() const
+	{
+		return StateSnapshotPublisher;
+	}
+
+	/**
+	 * Registers a listener which is invoked only for transitions matching the filter.
+	 * Unlike OnGameStateChangedNative, the cost of a transition depends only on the number of interested listeners.
+	 * Listeners which may be deferred are invoked over the following frames within DeferredListenersBudgetMs.
+	 *
+	 * @return A handle which is used to unsubscribe.
+	 */
+	FDelegateHandle SubscribeToTransition(const FTrickyTransitionFilter& Filter,
+	                                      FOnGameStateTransitionSignature::FDelegate&& Delegate,
+	                                      const FTrickyTransitionListenerOptions& Options = FTrickyTransitionListenerOptions());
+
+	/**
+	 * Removes a listener registered with SubscribeToTransition.
+	 *
+	 * @return True if the listener was removed.
+	 */
+	bool UnsubscribeFromTransition(const FDelegateHandle Handle);
+
+	/**
+	 * Returns a task which completes on the next transition matching the filter, so heavy setup can be prepared
+	 * on worker threads and continued on the game thread exactly when the transition happens.
+	 * Launch the continuation with the task and the setup tasks as prerequisites and
+	 * EExtendedTaskPriority::GameThreadNormalPri to resume on the game thread.
+	 *
+	 * @return A task which results in true if the transition happened or false if the game mode ended play first.
+	 */
+	UE::Tasks::TTask<bool> WaitForTransition(const FTrickyTransitionFilter& Filter);
+
+	/**
+	 * Same as WaitForTransition, but completes immediately if the game is already in the state.
+	 */
+	UE::Tasks::TTask<bool> WaitForGameState(const ETrickyGameState State);
+
+	/**
+	 * Returns a task which completes when the preparation timer reaches the milestone.
+	 * Requires TrickyGameStateBase, otherwise the task completes with false immediately.
+	 */
+	UE::Tasks::TTask<bool> WaitForPreparationMilestone(const FTrickyTimerMilestone& Milestone);
+
+	/**
+	 * Returns a task which completes when the game timer reaches the milestone.
+	 * Requires TrickyGameStateBase, otherwise the task completes with false immediately.
+	 */
+	UE::Tasks::TTask<bool> WaitForGameMilestone(const FTrickyTimerMilestone& Milestone);
+
+	/**
+	 * Registers an actor or a component, e.g. an AI controller or its components, which ticks according to the policy.
+	 * Tick modes are applied in one batch when the game state or inactivity reason changes.
+	 *
+	 * @return True if the object was registered.
+	 */
+	UFUNCTION(BlueprintCallable, Category=GameState)
+	bool RegisterTickPolicy(UObject* Object, const FTrickyTickPolicy& Policy);
+
+	/**
+	 * Unregisters the object and restores the tick settings it had before it was throttled.
+	 *
+	 * @return True if the object was unregistered.
+	 */
+	UFUNCTION(BlueprintCallable, Category=GameState)
+	bool UnregisterTickPolicy(UObject* Object);
+
+	/**
+	 * Registers a delegate of an object without a primary tick function, e.g. a subsystem,
+	 * which is invoked with the tick mode and interval when they change.
+	 *
+	 * @return A handle which is used to unregister.
+	 */
+	FDelegateHandle RegisterTickPolicyDelegate(const FTrickyTickPolicy& Policy, FOnTickModeChangedSignature&& Delegate);
+
+	bool UnregisterTickPolicyDelegate(const FDelegateHandle Handle);
+
+	/**
+	 * Starts a new match in the loaded map without travel.
+	 * Stops the timers, clears the result, rounds, player results and readiness, resets the actors registered
+	 * with TrickyGameModeLibrary::RegisterForRematch, and returns to InitialInactivityReason like StartPlay.
+	 *
+	 * @return True if the rematch was started.
+	 */
+	UFUNCTION(BlueprintCallable, Category=GameState)
+	bool Rematch();
+
+	/**
+	 * Finishes the current round with the result.
+	 * Starts the inter-round preparation, or finishes the game if the match is decided.
+	 *
+	 * @return True if the round was finished.
+	 */
+	UFUNCTION(BlueprintCallable, Category=GameState)
+	bool FinishRound(const EGameResult Result);
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE int32 GetCurrentRound() const { return CurrentRound; }
+
+	UFUNCTION(BlueprintPure, Category=GameState)
+	FORCEINLINE TArray<EGameResult> GetRoundResults() const { return RoundResults; }
+
+	/**
+	 * @return Number of finished rounds with the result.
+	 */
+	UFUNCTION(BlueprintPure, Category=GameState)
+	int32 GetRoundsNumWithResult(const EGameResult Result) const;
+
+	/**
+	 * Assigns a slot to the player, so its readiness, state and result are tracked.
+	 * Player controllers are registered on login and after seamless travel,
+	 * other controllers, e.g. bots, can be registered manually.
+	 *
+	 * @return The slot of the player.
+	 */
+	UFUNCTION(BlueprintCallable, Category=GameState)
+	int32 RegisterPlayer(AController* Player);
+
+	/**
+	 * Frees the slot of the player. Player controllers are unregistered on logout.
+	 *
+	 * @return True if the player was registered.
+	 */
+	UFUNCTION(BlueprintCallable, Category=GameState)
+	bool UnregisterPlayer(AController* Player);
+
+	/**
+	 * @param Team Index of the team, -1 removes the player from its team.
+	 * @return True if the team of the player changed.
+	 */
+	UFUNCTION(BlueprintCallable, Category=GameState)
+	bool SetPlayerTeam(AController* Player, const int32 Team);
+
+	/**
+	 * Finishes the player with the result, e.g. when it's eliminated, while the game stays active.
+	 * Finishes the game if AutoFinishCondition is met.
+	 *
+	 * @return True if the player was finished.
+	 */
+	UFUNCTION(BlueprintCallable, Category=GameState)
+	bool FinishPlayer(AController* Player, const EGameResult Result);
+
+	/**
+	 * Finishes all alive players of the team with the result.
+	 * Finishes the game if AutoFinishCondition is met.
+	 *
+	 * @return True if any player was finished.
+	 */
+	UFUNCTION(BlueprintCallable, Category=GameState)
+	bool FinishTeam(const int32 Team, const EGameResult Result);
+
+	UFUNCTION(BlueprintPure, Category=GameState)
+	ETrickyGameState GetPlayerGameState(const AController* Player) const;
+
+	UFUNCTION(BlueprintPure, Category=GameState)
+	EGameResult GetPlayerGameResult(const AController* Player) const;
+
+	/**
+	 * @return Number of registered players which aren't finished.
+	 */
+	UFUNCTION(BlueprintPure, Category=GameState)
+	int32 GetAlivePlayersNum() const { return Participants.GetAliveNum(); }
+
+	/**
+	 * @return Number of teams with at least one alive player.
+	 */
+	UFUNCTION(BlueprintPure, Category=GameState)
+	int32 GetRemainingTeamsNum() const { return Participants.GetTeamsRemainingNum(); }
+
+	UFUNCTION(BlueprintPure, Category=GameState)
+	int32 GetTeamAlivePlayersNum(const int32 Team) const { return Participants.GetTeamAliveNum(Team); }
+
+	UFUNCTION(BlueprintPure, Category=GameState)
+	ETrickyGameState GetTeamState(const int32 Team) const { return Participants.GetTeamState(Team); }
+
+	UFUNCTION(BlueprintPure, Category=GameState)
+	EGameResult GetTeamResult(const int32 Team) const { return Participants.GetTeamResult(Team); }
+
+	FORCEINLINE const FTrickyParticipantRegistry& GetParticipants() const { return Participants; }
+
+	/**
+	 * Updates the readiness of the player. When the ready check is enabled and the quorum of connected players
+	 * is ready during the preparation, the game starts without waiting for the preparation timer.
+	 *
+	 * @return True if the readiness of the player changed.
+	 */
+	UFUNCTION(BlueprintCallable, Category=GameState)
+	bool SetPlayerReady(AController* Player, const bool bIsReady);
+
+	/**
+	 * @return The ready check slot of the player, -1 if the player doesn't have one.
+	 */
+	UFUNCTION(BlueprintPure, Category=GameState)
+	int32 GetPlayerSlot(const AController* Player) const;
+
+	FORCEINLINE const FTrickyReadyCheck& GetReadyCheck() const { return ReadyCheck; }
+
 	UFUNCTION(BlueprintGetter, Category=GameState)
 	FORCEINLINE float GetPreparationDuration() const { return PreparationDuration; }
 
@@ -96,6 +421,60 @@ public:
 	UFUNCTION(BlueprintGetter, Category=GameState)
 	FORCEINLINE FTimerHandle GetPreparationTimerHandle() const { return PreparationTimerHandle; }
 
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE bool GetIsRoundBased() const { return bIsRoundBased; }
+
+	UFUNCTION(BlueprintSetter, Category=GameState)
+	void SetIsRoundBased(const bool Value);
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE int32 GetRoundsNum() const { return RoundsNum; }
+
+	UFUNCTION(BlueprintSetter, Category=GameState)
+	void SetRoundsNum(const int32 Value);
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE float GetRoundPreparationDuration() const { return RoundPreparationDuration; }
+
+	UFUNCTION(BlueprintSetter, Category=GameState)
+	void SetRoundPreparationDuration(const float Value);
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE ETrickyAutoFinishCondition GetAutoFinishCondition() const { return AutoFinishCondition; }
+
+	UFUNCTION(BlueprintSetter, Category=GameState)
+	void SetAutoFinishCondition(const ETrickyAutoFinishCondition Value);
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE bool GetIsReadyCheckEnabled() const { return bIsReadyCheckEnabled; }
+
+	UFUNCTION(BlueprintSetter, Category=GameState)
+	void SetIsReadyCheckEnabled(const bool Value);
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE float GetReadyCheckQuorum() const { return ReadyCheckQuorum; }
+
+	UFUNCTION(BlueprintSetter, Category=GameState)
+	void SetReadyCheckQuorum(const float Value);
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE float GetReadyCheckTimeout() const { return ReadyCheckTimeout; }
+
+	UFUNCTION(BlueprintSetter, Category=GameState)
+	void SetReadyCheckTimeout(const float Value);
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE float GetDeferredListenersBudgetMs() const { return DeferredListenersBudgetMs; }
+
+	UFUNCTION(BlueprintSetter, Category=GameState)
+	void SetDeferredListenersBudgetMs(const float Value);
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE FTrickyServerTickRates GetServerTickRates() const { return ServerTickRates; }
+
+	UFUNCTION(BlueprintSetter, Category=GameState)
+	void SetServerTickRates(const FTrickyServerTickRates& Value);
+
 	UFUNCTION(BlueprintGetter, Category=GameState)
 	FORCEINLINE bool GetIsSessionTimeLimited() const { return bIsSessionTimeLimited; }
 
@@ -155,6 +534,12 @@ public:
 	virtual float GetGameRemainingTime_Implementation() const override;
 
 protected:
+	/**
+	 * Registers the player and updates the server tick rate,
+	 * it's called both for logged in players and for players arriving with seamless travel.
+	 */
+	virtual void GenericPlayerInitialization(AController* C) override;
+
 	/**
 	 * Calculates the game result when the game time is over.
 	 * @warting it's used only when bIsGameTimeLimited == true.
@@ -166,6 +551,36 @@ protected:
 
 	virtual EGameResult CalculateTimeOverResult_Implementation() { return DefaultTimeOverResult; }
 
+	/**
+	 * Calculates the game result when AutoFinishCondition is met.
+	 *
+	 * @return The result of the game when it's finished automatically.
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category=GameState)
+	EGameResult CalculateAutoFinishResult();
+
+	virtual EGameResult CalculateAutoFinishResult_Implementation() { return EGameResult::Win; }
+
+	/**
+	 * Aggregates the round results into the result of the game.
+	 * By default, the result with more rounds between Win and Loose wins, otherwise it's a Draw.
+	 *
+	 * @return The result of the game when the match is decided.
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category=GameState)
+	EGameResult CalculateMatchResult();
+
+	virtual EGameResult CalculateMatchResult_Implementation();
+
+	/**
+	 * Determines whether the match is over after a round finished.
+	 * By default, it's over when all rounds are played or one side won the majority of RoundsNum.
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category=GameState)
+	bool IsMatchDecided();
+
+	virtual bool IsMatchDecided_Implementation();
+
 private:
 	/**
 	 * An inactivity reason which will be used when the game mode initialized
@@ -190,6 +605,58 @@ private:
 	UPROPERTY(BlueprintGetter=GetPreparationTimerHandle, Category=GameState)
 	FTimerHandle PreparationTimerHandle;
 
+	/**
+	 * Defines whether the preparation waits for the players to be ready instead of running PreparationDuration.
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		BlueprintGetter=GetIsReadyCheckEnabled,
+		BlueprintSetter=SetIsReadyCheckEnabled,
+		Category=GameState)
+	bool bIsReadyCheckEnabled = false;
+
+	/**
+	 * Fraction of the connected players which must be ready to start the game.
+	 * @warning Is used only if bIsReadyCheckEnabled == true.
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		BlueprintGetter=GetReadyCheckQuorum,
+		BlueprintSetter=SetReadyCheckQuorum,
+		Category=GameState,
+		meta=(ClampMin="0.0", ClampMax="1.0", UIMin="0.0", UIMax="1.0", EditCondition="bIsReadyCheckEnabled"))
+	float ReadyCheckQuorum = 1.0f;
+
+	/**
+	 * Time in seconds after which the game starts even if the quorum isn't reached. 0 means no timeout.
+	 * It replaces PreparationDuration as the duration of the preparation timer.
+	 * @warning Is used only if bIsReadyCheckEnabled == true.
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		BlueprintGetter=GetReadyCheckTimeout,
+		BlueprintSetter=SetReadyCheckTimeout,
+		Category=GameState,
+		meta=(ClampMin="0.0", UIMin="0.0", EditCondition="bIsReadyCheckEnabled"))
+	float ReadyCheckTimeout = 30.0f;
+
+	/**
+	 * Time in milliseconds per frame which can be spent on deferred transition listeners.
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		BlueprintGetter=GetDeferredListenersBudgetMs,
+		BlueprintSetter=SetDeferredListenersBudgetMs,
+		Category=GameState,
+		meta=(ClampMin="0.0", UIMin="0.0", Units="Milliseconds"))
+	float DeferredListenersBudgetMs = 2.0f;
+
+	/**
+	 * Tick rates of a dedicated server per game state and inactivity reason, applied on transitions and logins.
+	 * Lets idle servers, e.g. waiting for players or for teardown, use a fraction of the CPU.
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		BlueprintGetter=GetServerTickRates,
+		BlueprintSetter=SetServerTickRates,
+		Category=GameState)
+	FTrickyServerTickRates ServerTickRates;
+
 	/**
 	 * Defines whether the game session is time-limited.
 	 */
@@ -224,7 +691,82 @@ private:
 	UPROPERTY(BlueprintGetter=GetSessionTimerHandle, Category=GameState)
 	FTimerHandle GameTimerHandle;
 
-	float StartGameTime = 0.f;
+	/**
+	 * Defines whether the active phase is split into rounds. GameDuration limits every round.
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		BlueprintGetter=GetIsRoundBased,
+		BlueprintSetter=SetIsRoundBased,
+		Category=GameState)
+	bool bIsRoundBased = false;
+
+	/**
+	 * Maximum number of rounds, e.g. 3 for best-of-3.
+	 * @warning Is used only if bIsRoundBased == true.
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		BlueprintGetter=GetRoundsNum,
+		BlueprintSetter=SetRoundsNum,
+		Category=GameState,
+		meta=(ClampMin="1", UIMin="1", EditCondition="bIsRoundBased"))
+	int32 RoundsNum = 3;
+
+	/**
+	 * Duration of the preparation between rounds, the next round starts when it ends or right away if it's 0.
+	 * @warning Is used only if bIsRoundBased == true.
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		BlueprintGetter=GetRoundPreparationDuration,
+		BlueprintSetter=SetRoundPreparationDuration,
+		Category=GameState,
+		meta=(ClampMin="0.0", UIMin="0.0", EditCondition="bIsRoundBased"))
+	float RoundPreparationDuration = 3.0f;
+
+	/**
+	 * Number of the current round starting from 1, 0 before the first round.
+	 */
+	UPROPERTY(VisibleInstanceOnly, BlueprintGetter=GetCurrentRound, Category=GameState)
+	int32 CurrentRound = 0;
+
+	UPROPERTY(VisibleInstanceOnly, Category=GameState)
+	TArray<EGameResult> RoundResults;
+
+	/**
+	 * Defines when the game finishes automatically as players and teams finish.
+	 * The alive players of the last standing team or the last standing player win.
+	 */
+	UPROPERTY(EditDefaultsOnly,
+		BlueprintGetter=GetAutoFinishCondition,
+		BlueprintSetter=SetAutoFinishCondition,
+		Category=GameState)
+	ETrickyAutoFinishCondition AutoFinishCondition = ETrickyAutoFinishCondition::None;
+
+	/**
+	 * Phase start time and timer stamps, the stamps are replicated through TrickyGameStateBase.
+	 */
+	FTrickySessionClock SessionClock;
+
+	TSharedRef<FTrickyStateSnapshotPublisher, ESPMode::ThreadSafe> StateSnapshotPublisher =
+		MakeShared<FTrickyStateSnapshotPublisher, ESPMode::ThreadSafe>();
+
+	/**
+	 * Connected and ready players, replicated through TrickyGameStateBase.
+	 */
+	FTrickyReadyCheck ReadyCheck;
+
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<AController>, int32> PlayerSlots;
+
+	/**
+	 * Registered players indexed by their slots.
+	 */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AController>> SlotPlayers;
+
+	/**
+	 * States and results of the players and teams.
+	 */
+	FTrickyParticipantRegistry Participants;
 
 	/**
 	 * Current inactivity reason.
@@ -250,6 +792,52 @@ private:
 	UPROPERTY(VisibleInstanceOnly, Category=GameState)
 	EGameResult GameResult = EGameResult::None;
 
+	/**
+	 * Depth of nested state changes. Native transition events are triggered when the outermost change ends.
+	 */
+	int32 TransitionDepth = 0;
+
+	/**
+	 * The state the game was in when the outermost state change began.
+	 */
+	FTrickyGameStateTransition PendingTransition;
+
+	FTrickyGameStateTransition LastTransition;
+
+	/**
+	 * Native events of the outermost transition in the order they happened.
+	 */
+	TArray<ETrickyNativeTransitionEvent, TInlineAllocator<4>> PendingNativeEvents;
+
+	FTrickyTransitionDispatcher TransitionDispatcher;
+
+	/**
+	 * Tasks returned by WaitForTransition and the milestone waits, cancelled when the game mode ends play.
+	 */
+	FTrickyTaskWaitList TaskWaits;
+
+	/**
+	 * Objects which change their tick rate with the game state.
+	 */
+	FTrickyTickPolicyRegistry TickPolicies;
+
+	/**
+	 * NetServerMaxTickRate of the net driver before the game mode changed it, 0 if it wasn't changed.
+	 */
+	int32 DefaultServerTickRate = 0;
+
+	/**
+	 * Checks for new connections while no players are connected. It's a core ticker, so it runs while the game is paused.
+	 */
+	FTSTicker::FDelegateHandle HibernationTickerHandle;
+
+	/**
+	 * Calls the interface functions of this game mode, skipping the reflection system if they aren't overridden in Blueprint.
+	 */
+	FGameStateControllerCaller SelfCaller;
+
+	friend struct FTrickyTransitionScope;
+
 
 	virtual bool ChangeInactivityReason_Implementation(const EGameInactivityReason NewInactivityReason) override;
 
@@ -264,6 +852,40 @@ private:
 	UFUNCTION()
 	void HandlePreparationTimerFinished();
 
+	/**
+	 * @return Duration of the preparation timer, ReadyCheckTimeout if the ready check is enabled.
+	 */
+	float GetPreparationTimerDuration() const;
+
+	/**
+	 * Enters InitialInactivityReason and starts the preparation timer if needed, used by StartPlay and Rematch.
+	 */
+	void EnterInitialState();
+
+	/**
+	 * @return True if the game is between rounds, i.e. at least one round was played.
+	 */
+	FORCEINLINE bool IsBetweenRounds() const { return bIsRoundBased && CurrentRound > 0; }
+
+	/**
+	 * Starts the game if the ready check is enabled, the game is preparing and the quorum is reached.
+	 */
+	void TryCompleteReadyCheck();
+
+	void UpdateReplicatedReadyCheck() const;
+
+	void UpdateReplicatedRound() const;
+
+	/**
+	 * Finishes the alive players with the result and triggers the events of the finished players and teams.
+	 */
+	void FinishPlayersInSlots(const TArray<int32>& Slots, const EGameResult Result);
+
+	/**
+	 * Finishes the game if the game is active and AutoFinishCondition is met.
+	 */
+	void TryAutoFinishGame();
+
 	/**
 	 * Stops the preparation timer.
 	 *
@@ -310,7 +932,7 @@ private:
 	 * @return True if the game timer was successfully paused.
 	 */
 	UFUNCTION(BlueprintCallable, Category=GameState)
-	bool PauseGameTimer() const;
+	bool PauseGameTimer();
 
 	/**
 	 * Unpauses the game timer.
@@ -318,7 +940,7 @@ private:
 	 * @return True if the game timer was successfully unpaused.
 	 */
 	UFUNCTION(BlueprintCallable, Category=GameState)
-	bool UnPauseGameTimer() const;
+	bool UnPauseGameTimer();
 
 	UFUNCTION()
 	void HandleGameTimerFinished();
@@ -326,15 +948,44 @@ private:
 	UFUNCTION()
 	bool ChangeGameState(const ETrickyGameState NewState);
 
-#if WITH_EDITOR || !UE_BUILD_SHIPPING
-	void PrintWarning(const FString& Message) const;
+	/**
+	 * Pushes the current state to TrickyGameStateBase, so it's replicated to clients.
+	 */
+	void UpdateReplicatedState() const;
 
-	void PrintLog(const FString& Message) const;
+	/**
+	 * Pushes the timer stamps to TrickyGameStateBase, so clients can compute the timers locally.
+	 */
+	void UpdateReplicatedTimers();
 
-	static void GetGameStateName(FString& StateName, const ETrickyGameState State);
+	/**
+	 * Publishes the current state and session clock for other threads.
+	 * Called when the outermost transition ends and when a timer changes outside a transition.
+	 */
+	void PublishStateSnapshot();
 
-	static void GetInactivityReasonName(FString& ReasonName, const EGameInactivityReason Reason);
+	UE::Tasks::TTask<bool> WaitForMilestone(const FTrickyTimerMilestone& Milestone, const bool bIsPreparation);
 
-	static void GetGameResultName(FString& ResultName, const EGameResult Result);
-#endif
+	/**
+	 * Sets NetServerMaxTickRate of a dedicated server according to ServerTickRates.
+	 * Connections which haven't finished the login keep the server awake.
+	 *
+	 * @param ExitingPlayer A player which is logging out and must not be counted.
+	 */
+	void UpdateServerTickRate(const AController* ExitingPlayer = nullptr);
+
+	bool HandleHibernationTick(float DeltaTime);
+
+	void RestoreServerTickRate();
+
+	void BeginTransition();
+
+	void EndTransition();
+
+	void BroadcastPendingNativeEvents(const FTrickyGameStateTransition& Transition);
+
+	/**
+	 * Builds a transition from the state captured by BeginTransition to the current one.
+	 */
+	FTrickyGameStateTransition MakeTransition() const;
 };
@@ -3,13 +3,19 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "TrickySessionManagerSubsystem.h"
+#include "TrickyTickPolicy.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "TrickyGameModeLibrary.generated.h"
 
 enum class ETrickyGameState : uint8;
 enum class EGameResult : uint8;
 enum class EGameInactivityReason : uint8;
+class AActor;
 class ATrickyGameModeBase;
+class ATrickyGameStateBase;
+class UTrickyCountdownViewModel;
+class FGameStateControllerCaller;
 
 /**
  * Provides utility functions related to the Tricky GameMode.
@@ -28,6 +34,23 @@ public:
 	UFUNCTION(BlueprintPure, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
 	static ATrickyGameModeBase* GetTrickyGameMode(const UObject* WorldContextObject);
 
+	/**
+	 * Retrieves the current game state cast to the TrickyGameStateBase type.
+	 * Unlike the game mode, it's available on clients.
+	 *
+	 * @return A pointer to the TrickyGameStateBase.
+	 */
+	UFUNCTION(BlueprintPure, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static ATrickyGameStateBase* GetTrickyGameState(const UObject* WorldContextObject);
+
+	/**
+	 * Retrieves the countdown view model of the game state for UMG bindings.
+	 *
+	 * @return A pointer to the view model, nullptr if the game state isn't a TrickyGameStateBase or on a dedicated server.
+	 */
+	UFUNCTION(BlueprintPure, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static UTrickyCountdownViewModel* GetCountdownViewModel(const UObject* WorldContextObject);
+
 	/**
 	 * Initiates the start of the game, transitioning it into an active state.
 	 *
@@ -143,7 +166,148 @@ public:
 	UFUNCTION(BlueprintPure, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
 	static float GetGamePreparationElapsedTime(const UObject* WorldContextObject);
 
+	/**
+	 * Registers an actor implementing TrickyRematchResettable, so it's reset when a rematch starts.
+	 *
+	 * @return True if the actor was registered.
+	 */
+	UFUNCTION(BlueprintCallable, Category=TrickyGameMode)
+	static bool RegisterForRematch(AActor* Actor);
+
+	/**
+	 * Unregisters an actor registered with RegisterForRematch, e.g. in its EndPlay.
+	 *
+	 * @return True if the actor was unregistered.
+	 */
+	UFUNCTION(BlueprintCallable, Category=TrickyGameMode)
+	static bool UnregisterFromRematch(AActor* Actor);
+
+	/**
+	 * Registers an actor or a component in the tick policies of TrickyGameModeBase. Works only on the server.
+	 *
+	 * @return True if the object was registered.
+	 */
+	UFUNCTION(BlueprintCallable, Category=TrickyGameMode)
+	static bool RegisterTickPolicy(UObject* Object, const FTrickyTickPolicy& Policy);
+
+	/**
+	 * Unregisters an object registered with RegisterTickPolicy and restores its original tick settings.
+	 *
+	 * @return True if the object was unregistered.
+	 */
+	UFUNCTION(BlueprintCallable, Category=TrickyGameMode)
+	static bool UnregisterTickPolicy(UObject* Object);
+
+	/**
+	 * Creates a session of TrickySessionManagerSubsystem.
+	 *
+	 * @return Id of the created session, invalid if there is no session manager.
+	 */
+	UFUNCTION(BlueprintCallable, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static FTrickySessionId CreateSession(const UObject* WorldContextObject, const FTrickySessionSettings& Settings);
+
+	/**
+	 * Destroys a session of TrickySessionManagerSubsystem.
+	 *
+	 * @return True if the session was destroyed.
+	 */
+	UFUNCTION(BlueprintCallable, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static bool DestroySession(const UObject* WorldContextObject, const FTrickySessionId& SessionId);
+
+	/**
+	 * Session version of StartGame.
+	 */
+	UFUNCTION(BlueprintCallable, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static bool StartSessionGame(const UObject* WorldContextObject, const FTrickySessionId& SessionId);
+
+	/**
+	 * Session version of StopGame.
+	 */
+	UFUNCTION(BlueprintCallable, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static bool StopSessionGame(const UObject* WorldContextObject,
+	                            const FTrickySessionId& SessionId,
+	                            EGameInactivityReason Reason);
+
+	/**
+	 * Session version of FinishGame.
+	 */
+	UFUNCTION(BlueprintCallable, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static bool FinishSessionGame(const UObject* WorldContextObject,
+	                              const FTrickySessionId& SessionId,
+	                              EGameResult Result);
+
+	/**
+	 * Session version of ChangeInactivityReason.
+	 */
+	UFUNCTION(BlueprintCallable, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static bool ChangeSessionInactivityReason(const UObject* WorldContextObject,
+	                                          const FTrickySessionId& SessionId,
+	                                          EGameInactivityReason Reason);
+
+	/**
+	 * Session version of StartPreparation.
+	 */
+	UFUNCTION(BlueprintCallable, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static bool StartSessionPreparation(const UObject* WorldContextObject, const FTrickySessionId& SessionId);
+
+	/**
+	 * Session version of StartCutscene.
+	 */
+	UFUNCTION(BlueprintCallable, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static bool StartSessionCutscene(const UObject* WorldContextObject, const FTrickySessionId& SessionId);
+
+	/**
+	 * Session version of StartTransition.
+	 */
+	UFUNCTION(BlueprintCallable, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static bool StartSessionTransition(const UObject* WorldContextObject, const FTrickySessionId& SessionId);
+
+	/**
+	 * Session version of GetGameState.
+	 */
+	UFUNCTION(BlueprintPure, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static ETrickyGameState GetSessionGameState(const UObject* WorldContextObject, const FTrickySessionId& SessionId);
+
+	/**
+	 * Session version of GetGameResult.
+	 */
+	UFUNCTION(BlueprintPure, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static EGameResult GetSessionGameResult(const UObject* WorldContextObject, const FTrickySessionId& SessionId);
+
+	/**
+	 * Session version of GetInactivityReason.
+	 */
+	UFUNCTION(BlueprintPure, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static EGameInactivityReason GetSessionInactivityReason(const UObject* WorldContextObject,
+	                                                        const FTrickySessionId& SessionId);
+
+	/**
+	 * Session version of GetGameElapsedTime.
+	 */
+	UFUNCTION(BlueprintPure, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static float GetSessionElapsedTime(const UObject* WorldContextObject, const FTrickySessionId& SessionId);
+
+	/**
+	 * Session version of GetGameRemainingTime.
+	 */
+	UFUNCTION(BlueprintPure, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static float GetSessionRemainingTime(const UObject* WorldContextObject, const FTrickySessionId& SessionId);
+
+	/**
+	 * Session version of GetGamePreparationRemainingTime.
+	 */
+	UFUNCTION(BlueprintPure, Category=TrickyGameMode, meta=(WorldContext="WorldContextObject"))
+	static float GetSessionPreparationRemainingTime(const UObject* WorldContextObject,
+	                                                const FTrickySessionId& SessionId);
+
 private:
-	UFUNCTION()
-	static bool ImplementsGameStateInterface(const UObject* WorldContextObject);
+	/**
+	 * Returns the game state controller cached by TrickyGameModeSubsystem.
+	 */
+	static UObject* GetGameStateController(const UObject* WorldContextObject);
+
+	/**
+	 * Returns the caller of the cached game state controller, nullptr if there is no controller.
+	 */
+	static const FGameStateControllerCaller* GetGameStateControllerCaller(const UObject* WorldContextObject);
 };
@@ -0,0 +1,79 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameStateControllerInterface.h"
+#include "TrickyRematchResettable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TrickyGameModeSubsystem.generated.h"
+
+class AGameModeBase;
+
+/**
+ * Resolves and caches the object implementing GameStateControllerInterface for its world,
+ * so the library doesn't look up and check the game mode on every call.
+ */
+UCLASS()
+class TRICKYGAMEMODE_API UTrickyGameModeSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/**
+	 * Returns the subsystem of the world the given object belongs to.
+	 */
+	static UTrickyGameModeSubsystem* Get(const UObject* WorldContextObject);
+
+	/**
+	 * Returns the cached object implementing GameStateControllerInterface, nullptr if there is none.
+	 */
+	FORCEINLINE UObject* GetGameStateController() const { return GameStateController; }
+
+	/**
+	 * Returns the caller of the cached controller, which skips the reflection system for native functions.
+	 */
+	FORCEINLINE const FGameStateControllerCaller& GetGameStateControllerCaller() const { return ControllerCaller; }
+
+	/**
+	 * Caches the given object if it implements GameStateControllerInterface.
+	 *
+	 * @return True if the object was cached.
+	 */
+	bool SetGameStateController(UObject* Controller);
+
+	/**
+	 * Clears the cached controller if it's the given object.
+	 */
+	void ResetGameStateController(const UObject* Controller);
+
+	/**
+	 * Returns the actors which are reset when TrickyGameModeBase starts a rematch.
+	 */
+	FORCEINLINE FTrickyRematchRegistry& GetRematchRegistry() { return RematchRegistry; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	UPROPERTY(Transient)
+	TObjectPtr<UObject> GameStateController = nullptr;
+
+	FGameStateControllerCaller ControllerCaller;
+
+	FTrickyRematchRegistry RematchRegistry;
+
+	FDelegateHandle GameModeInitializedHandle;
+
+	FDelegateHandle WorldCleanupHandle;
+
+	void HandleGameModeInitialized(AGameModeBase* GameMode);
+
+	void HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+};
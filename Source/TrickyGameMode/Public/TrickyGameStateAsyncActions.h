@@ -0,0 +1,175 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameStateControllerInterface.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "TrickyGameStateAsyncActions.generated.h"
+
+class ATrickyGameModeBase;
+class ATrickyGameStateBase;
+struct FTrickyTimerMilestone;
+struct FTrickyTimerStamp;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnTrickyWaitCompletedSignature);
+
+/**
+ * Base class of the async actions which wait for a condition of the game state instead of polling it on tick.
+ * Completes immediately if the condition already holds, otherwise subscribes to the game mode on the server
+ * or to the game state on clients. Subscriptions are removed when the action completes or the game mode
+ * or game state ends play.
+ */
+UCLASS(Abstract)
+class TRICKYGAMEMODE_API UTrickyGameStateAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Triggered when the condition holds.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnTrickyWaitCompletedSignature Completed;
+
+	virtual void Activate() override;
+
+	virtual void SetReadyToDestroy() override;
+
+protected:
+	TWeakObjectPtr<UObject> WorldContext;
+
+	TWeakObjectPtr<ATrickyGameModeBase> GameMode;
+
+	TWeakObjectPtr<ATrickyGameStateBase> GameState;
+
+	virtual bool IsConditionMet() const PURE_VIRTUAL(UTrickyGameStateAsyncAction::IsConditionMet, return false;);
+
+	/**
+	 * Subscribes to the events which may change the condition.
+	 *
+	 * @return True if subscribed.
+	 */
+	virtual bool Subscribe() PURE_VIRTUAL(UTrickyGameStateAsyncAction::Subscribe, return false;);
+
+	virtual void Unsubscribe() {}
+
+	/**
+	 * Triggers Completed and destroys the action.
+	 */
+	void Complete();
+
+	void HandleTransition(const FTrickyGameStateTransition& Transition);
+
+	/**
+	 * Completes the action if the condition holds, used by the dynamic events of the game state.
+	 */
+	void CompleteIfConditionMet();
+
+private:
+	bool bIsActive = false;
+
+	UFUNCTION()
+	void HandleEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+};
+
+/**
+ * Waits until the game enters the state.
+ */
+UCLASS()
+class TRICKYGAMEMODE_API UTrickyWaitForGameStateAction : public UTrickyGameStateAsyncAction
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable,
+		Category=TrickyGameMode,
+		meta=(BlueprintInternalUseOnly="true", WorldContext="WorldContextObject", DisplayName="Wait For Game State"))
+	static UTrickyWaitForGameStateAction* WaitForGameState(UObject* WorldContextObject, ETrickyGameState State);
+
+protected:
+	virtual bool IsConditionMet() const override;
+
+	virtual bool Subscribe() override;
+
+	virtual void Unsubscribe() override;
+
+private:
+	ETrickyGameState State = ETrickyGameState::Inactive;
+
+	FDelegateHandle TransitionHandle;
+
+	UFUNCTION()
+	void HandleGameStateChanged(const ETrickyGameState NewState);
+};
+
+/**
+ * Waits until the game becomes inactive with the inactivity reason.
+ * The None reason waits until the game is no longer inactive.
+ */
+UCLASS()
+class TRICKYGAMEMODE_API UTrickyWaitForInactivityReasonAction : public UTrickyGameStateAsyncAction
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable,
+		Category=TrickyGameMode,
+		meta=(BlueprintInternalUseOnly="true",
+			WorldContext="WorldContextObject",
+			DisplayName="Wait For Inactivity Reason"))
+	static UTrickyWaitForInactivityReasonAction* WaitForInactivityReason(UObject* WorldContextObject,
+	                                                                    EGameInactivityReason Reason);
+
+protected:
+	virtual bool IsConditionMet() const override;
+
+	virtual bool Subscribe() override;
+
+	virtual void Unsubscribe() override;
+
+private:
+	EGameInactivityReason Reason = EGameInactivityReason::None;
+
+	FDelegateHandle TransitionHandle;
+
+	UFUNCTION()
+	void HandleInactivityReasonChanged(const EGameInactivityReason NewReason);
+};
+
+/**
+ * Waits until the remaining time of a time-limited game is less or equal to the given time.
+ * Uses a milestone of the game timer, so it works on the server and clients and survives pauses.
+ * If the time is greater or equal to the game duration, completes as soon as the game timer starts.
+ */
+UCLASS()
+class TRICKYGAMEMODE_API UTrickyWaitForRemainingTimeAction : public UTrickyGameStateAsyncAction
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable,
+		Category=TrickyGameMode,
+		meta=(BlueprintInternalUseOnly="true",
+			WorldContext="WorldContextObject",
+			DisplayName="Wait For Remaining Time"))
+	static UTrickyWaitForRemainingTimeAction* WaitForRemainingTime(UObject* WorldContextObject, float Time);
+
+protected:
+	virtual bool IsConditionMet() const override;
+
+	virtual bool Subscribe() override;
+
+	virtual void Unsubscribe() override;
+
+private:
+	float Time = 0.f;
+
+	FDelegateHandle MilestoneHandle;
+
+	FDelegateHandle GameTimerHandle;
+
+	void HandleMilestoneReached(const FTrickyTimerMilestone& Milestone);
+
+	void HandleGameTimerChanged(const FTrickyTimerStamp& Timer);
+};
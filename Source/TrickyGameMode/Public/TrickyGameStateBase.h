@@ -0,0 +1,327 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameStateControllerInterface.h"
+#include "TrickyCountdownViewModel.h"
+#include "TrickyMilestoneScheduler.h"
+#include "TrickyReadyCheck.h"
+#include "TrickyTimerStamp.h"
+#include "GameFramework/GameStateBase.h"
+#include "TrickyGameStateBase.generated.h"
+
+/**
+ * A compact copy of the game mode state which is replicated to clients.
+ * Phase timing isn't included, it's derived from the replicated PreparationTimer and GameTimer.
+ */
+USTRUCT(BlueprintType)
+struct TRICKYGAMEMODE_API FTrickyReplicatedGameState
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=GameState)
+	ETrickyGameState State = ETrickyGameState::Inactive;
+
+	UPROPERTY(BlueprintReadOnly, Category=GameState)
+	ETrickyGameState LastState = ETrickyGameState::Inactive;
+
+	UPROPERTY(BlueprintReadOnly, Category=GameState)
+	EGameInactivityReason InactivityReason = EGameInactivityReason::None;
+
+	UPROPERTY(BlueprintReadOnly, Category=GameState)
+	EGameResult Result = EGameResult::None;
+
+	/**
+	 * Packs all enums into 10 bits.
+	 */
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FTrickyReplicatedGameState& Other) const;
+
+	bool operator!=(const FTrickyReplicatedGameState& Other) const { return !(*this == Other); }
+};
+
+template<>
+struct TStructOpsTypeTraits<FTrickyReplicatedGameState> : public TStructOpsTypeTraitsBase2<FTrickyReplicatedGameState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnReadyCheckChangedDynamicSignature,
+                                             int32,
+                                             ReadyNum,
+                                             int32,
+                                             ConnectedNum);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnRoundChangedDynamicSignature, int32, Round);
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTimerStampChangedSignature, const FTrickyTimerStamp& /*Timer*/);
+
+/**
+ * A game state which mirrors the state of TrickyGameModeBase on clients.
+ * Implements the getters of GameStateControllerInterface, so the library works on clients too.
+ */
+UCLASS(Blueprintable, BlueprintType)
+class TRICKYGAMEMODE_API ATrickyGameStateBase : public AGameStateBase, public IGameStateControllerInterface
+{
+	GENERATED_BODY()
+
+public:
+	ATrickyGameStateBase();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	virtual void PostInitializeComponents() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/**
+	 * Triggered when the replicated game state changed.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnGameStateChangedDynamicSignature OnGameStateChanged;
+
+	/**
+	 * Triggered when the replicated game state changed to Finished or the game result changed.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnGameFinishedDynamicSignature OnGameFinished;
+
+	/**
+	 * Triggered when the replicated inactivity reason changed.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnGameInactivityReasonChangedDynamicSignature OnInactivityReasonChanged;
+
+	/**
+	 * Triggered when the preparation timer reaches one of PreparationMilestones.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnTimerMilestoneDynamicSignature OnPreparationMilestoneReached;
+
+	/**
+	 * Triggered when the game timer reaches one of GameMilestones.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnTimerMilestoneDynamicSignature OnGameMilestoneReached;
+
+	/**
+	 * Triggered when a new round of a round-based game started.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnRoundChangedDynamicSignature OnRoundChanged;
+
+	/**
+	 * Triggered when a player connected, disconnected or changed their readiness.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnReadyCheckChangedDynamicSignature OnReadyCheckChanged;
+
+	/**
+	 * Triggered on the server and on clients when the game timer starts, stops, pauses or unpauses.
+	 */
+	FOnTimerStampChangedSignature OnGameTimerChangedNative;
+
+	/**
+	 * Registers a listener which is invoked when the preparation timer reaches the milestone,
+	 * on the server and on clients.
+	 *
+	 * @return A handle which is used to remove the listener.
+	 */
+	FDelegateHandle AddPreparationMilestone(const FTrickyTimerMilestone& Milestone,
+	                                        FOnTimerMilestoneSignature::FDelegate&& Delegate);
+
+	bool RemovePreparationMilestone(const FDelegateHandle Handle);
+
+	/**
+	 * Registers a listener which is invoked when the game timer reaches the milestone, on the server and on clients.
+	 * Remaining time milestones are reached only in time-limited sessions.
+	 *
+	 * @return A handle which is used to remove the listener.
+	 */
+	FDelegateHandle AddGameMilestone(const FTrickyTimerMilestone& Milestone,
+	                                 FOnTimerMilestoneSignature::FDelegate&& Delegate);
+
+	bool RemoveGameMilestone(const FDelegateHandle Handle);
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE UTrickyCountdownViewModel* GetCountdownViewModel() const { return CountdownViewModel; }
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE FTrickyReplicatedGameState GetReplicatedState() const { return ReplicatedState; }
+
+	/**
+	 * Updates the replicated state. Marks it dirty only if something changed.
+	 * @warning Must be called only on the server.
+	 */
+	void SetReplicatedState(const FTrickyReplicatedGameState& NewState);
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE FTrickyTimerStamp GetPreparationTimer() const { return PreparationTimer; }
+
+	/**
+	 * Updates the replicated preparation timer stamp.
+	 * @warning Must be called only on the server.
+	 */
+	void SetPreparationTimer(const FTrickyTimerStamp& NewTimer);
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE FTrickyTimerStamp GetGameTimer() const { return GameTimer; }
+
+	/**
+	 * Updates the replicated game timer stamp.
+	 * @warning Must be called only on the server.
+	 */
+	void SetGameTimer(const FTrickyTimerStamp& NewTimer);
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE int32 GetCurrentRound() const { return CurrentRound; }
+
+	/**
+	 * Updates the replicated round number.
+	 * @warning Must be called only on the server.
+	 */
+	void SetCurrentRound(const int32 NewRound);
+
+	UFUNCTION(BlueprintGetter, Category=GameState)
+	FORCEINLINE FTrickyReadyCheck GetReadyCheck() const { return ReadyCheck; }
+
+	/**
+	 * Updates the replicated ready check.
+	 * @warning Must be called only on the server.
+	 */
+	void SetReadyCheck(const FTrickyReadyCheck& NewReadyCheck);
+
+	/**
+	 * @return True if the player in the slot is ready.
+	 */
+	UFUNCTION(BlueprintPure, Category=GameState)
+	bool IsPlayerSlotReady(const int32 Slot) const { return ReadyCheck.IsReady(Slot); }
+
+	/**
+	 * Retrieves the elapsed time of the preparation timer computed from the server world time.
+	 *
+	 * @return elapsed preparation time in seconds, -1 if the timer isn't active.
+	 */
+	UFUNCTION(BlueprintPure, Category=GameState)
+	float GetPreparationElapsedTime() const;
+
+	/**
+	 * Retrieves the remaining time of the preparation timer computed from the server world time.
+	 *
+	 * @return remaining preparation time in seconds, -1 if the timer isn't active.
+	 */
+	UFUNCTION(BlueprintPure, Category=GameState)
+	float GetPreparationRemainingTime() const;
+
+	virtual ETrickyGameState GetGameState_Implementation() const override;
+
+	virtual EGameResult GetGameResult_Implementation() const override;
+
+	virtual EGameInactivityReason GetGameInactivityReason_Implementation() const override;
+
+	virtual float GetGameElapsedTime_Implementation() const override;
+
+	virtual float GetGameRemainingTime_Implementation() const override;
+
+private:
+	UPROPERTY(ReplicatedUsing=OnRep_ReplicatedState, BlueprintGetter=GetReplicatedState, Category=GameState)
+	FTrickyReplicatedGameState ReplicatedState;
+
+	UPROPERTY(ReplicatedUsing=OnRep_PreparationTimer, BlueprintGetter=GetPreparationTimer, Category=GameState)
+	FTrickyTimerStamp PreparationTimer;
+
+	UPROPERTY(ReplicatedUsing=OnRep_GameTimer, BlueprintGetter=GetGameTimer, Category=GameState)
+	FTrickyTimerStamp GameTimer;
+
+	UPROPERTY(ReplicatedUsing=OnRep_CurrentRound, BlueprintGetter=GetCurrentRound, Category=GameState)
+	int32 CurrentRound = 0;
+
+	UPROPERTY(ReplicatedUsing=OnRep_ReadyCheck, BlueprintGetter=GetReadyCheck, Category=GameState)
+	FTrickyReadyCheck ReadyCheck;
+
+	/**
+	 * Milestones of the preparation timer which trigger OnPreparationMilestoneReached.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category=GameState)
+	TArray<FTrickyTimerMilestone> PreparationMilestones;
+
+	/**
+	 * Milestones of the game timer which trigger OnGameMilestoneReached, e.g. 60, 10, 9, 8... seconds remaining.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category=GameState)
+	TArray<FTrickyTimerMilestone> GameMilestones;
+
+	/**
+	 * Class of the view model which is created for UMG bindings. It isn't created on dedicated servers.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category=GameState)
+	TSubclassOf<UTrickyCountdownViewModel> CountdownViewModelClass = UTrickyCountdownViewModel::StaticClass();
+
+	UPROPERTY(Transient, BlueprintGetter=GetCountdownViewModel, Category=GameState)
+	TObjectPtr<UTrickyCountdownViewModel> CountdownViewModel;
+
+	FTrickyMilestoneScheduler PreparationMilestoneScheduler;
+
+	FTrickyMilestoneScheduler GameMilestoneScheduler;
+
+	/**
+	 * Locally predicted state which is used on clients until the server confirms it.
+	 */
+	FTrickyReplicatedGameState PredictedState;
+
+	bool bIsStatePredicted = false;
+
+	/**
+	 * Server time when the predicted preparation timer ended.
+	 */
+	double PredictedPreparationEndTime = -1.0;
+
+	FTimerHandle PreparationPredictionHandle;
+
+	UFUNCTION()
+	void OnRep_ReplicatedState(const FTrickyReplicatedGameState& PreviousState);
+
+	UFUNCTION()
+	void OnRep_PreparationTimer();
+
+	UFUNCTION()
+	void OnRep_GameTimer();
+
+	UFUNCTION()
+	void OnRep_CurrentRound();
+
+	UFUNCTION()
+	void OnRep_ReadyCheck();
+
+	void HandlePreparationMilestoneReached(const FTrickyTimerMilestone& Milestone);
+
+	void HandleGameMilestoneReached(const FTrickyTimerMilestone& Milestone);
+
+	FORCEINLINE const FTrickyReplicatedGameState& GetEffectiveState() const
+	{
+		return bIsStatePredicted ? PredictedState : ReplicatedState;
+	}
+
+	void BroadcastStateChanges(const FTrickyReplicatedGameState& PreviousState);
+
+	void RefreshCountdownViewModel() const;
+
+	/**
+	 * Schedules a local timer which flips the state to Active when the preparation timer ends on clients.
+	 */
+	void UpdatePreparationPrediction();
+
+	void HandlePreparationPredictionFinished();
+
+	/**
+	 * Returns to the replicated state if the preparation timer was paused or restarted after the prediction,
+	 * i.e. the server didn't start the game.
+	 */
+	void RollBackPreparationPrediction();
+};
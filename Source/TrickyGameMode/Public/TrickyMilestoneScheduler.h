@@ -0,0 +1,146 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TrickyTimerStamp.h"
+#include "TimerManager.h"
+#include "TrickyMilestoneScheduler.generated.h"
+
+UENUM(BlueprintType)
+enum class ETrickyMilestoneType : uint8
+{
+	Elapsed,
+	Remaining
+};
+
+/**
+ * A moment of a timer defined by its elapsed or remaining time.
+ */
+USTRUCT(BlueprintType)
+struct TRICKYGAMEMODE_API FTrickyTimerMilestone
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Timer)
+	ETrickyMilestoneType Type = ETrickyMilestoneType::Remaining;
+
+	/**
+	 * Elapsed or remaining time in seconds when the milestone is reached.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Timer, meta=(ClampMin="0.0", UIMin="0.0"))
+	float Time = 0.f;
+
+	/**
+	 * @return Elapsed time of the milestone for a timer with the given duration, negative if it can't be reached.
+	 */
+	double GetElapsedTime(const float Duration) const;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTimerMilestoneSignature, const FTrickyTimerMilestone&);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTimerMilestoneDynamicSignature,
+                                            const FTrickyTimerMilestone&,
+                                            Milestone);
+
+/**
+ * Invokes listeners when a timer reaches their milestones.
+ * The milestones are kept sorted by elapsed time and only the next due one is armed in the timer manager,
+ * so listeners don't need to poll the remaining time every frame.
+ * The schedule is rebuilt from the timer stamp whenever it changes, so it stays correct across pauses.
+ */
+class TRICKYGAMEMODE_API FTrickyMilestoneScheduler
+{
+public:
+	FTrickyMilestoneScheduler() = default;
+
+	~FTrickyMilestoneScheduler();
+
+	FTrickyMilestoneScheduler(const FTrickyMilestoneScheduler&) = delete;
+
+	FTrickyMilestoneScheduler& operator=(const FTrickyMilestoneScheduler&) = delete;
+
+	/**
+	 * Registers a listener for the milestone. If the timer is running, the milestone is scheduled immediately.
+	 *
+	 * @return A handle which is used to remove the listener.
+	 */
+	FDelegateHandle Add(const FTrickyTimerMilestone& Milestone, FOnTimerMilestoneSignature::FDelegate&& Delegate);
+
+	/**
+	 * @return True if the listener was removed.
+	 */
+	bool Remove(const FDelegateHandle Handle);
+
+	/**
+	 * Schedules the milestones of the timer described by the stamp. Must be called whenever the stamp changes.
+	 * When the timer ends, the milestones at its very end are invoked.
+	 *
+	 * @param Now Current time in the clock of the stamp.
+	 */
+	void Sync(UWorld* InWorld, const FTrickyTimerStamp& Stamp, const double Now);
+
+	/**
+	 * Stops the schedule and removes all listeners.
+	 */
+	void Reset();
+
+private:
+	struct FListener
+	{
+		FDelegateHandle Handle;
+
+		FTrickyTimerMilestone Milestone;
+
+		FOnTimerMilestoneSignature::FDelegate Delegate;
+	};
+
+	struct FScheduledMilestone
+	{
+		double ElapsedTime = 0.0;
+
+		int32 ListenerIndex = INDEX_NONE;
+	};
+
+	TArray<FListener> Listeners;
+
+	/**
+	 * Milestones of the current timer run sorted by elapsed time. The ones before NextIndex were already reached.
+	 */
+	TArray<FScheduledMilestone> Schedule;
+
+	int32 NextIndex = 0;
+
+	/**
+	 * Elapsed time of the last reached milestone of the current timer run.
+	 */
+	double ReachedElapsedTime = -1.0;
+
+	FTrickyTimerStamp SyncedStamp;
+
+	/**
+	 * Difference between the clock of the stamp and the world time, e.g. the server time offset on clients.
+	 */
+	double ClockOffset = 0.0;
+
+	TWeakObjectPtr<UWorld> World;
+
+	FTimerHandle TimerHandle;
+
+	bool bIsInvoking = false;
+
+	bool bIsScheduleDirty = false;
+
+	void ClearTimer();
+
+	/**
+	 * Rebuilds the schedule from the synced stamp and arms the next milestone.
+	 */
+	void Reschedule();
+
+	void ArmNextMilestone(const double ElapsedTime);
+
+	void HandleMilestoneDue();
+
+	void InvokeMilestones(const double ElapsedTime);
+};
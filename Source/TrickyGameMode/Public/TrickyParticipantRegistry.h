@@ -0,0 +1,85 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameStateControllerInterface.h"
+
+/**
+ * States and results of individual players and teams, stored in packed arrays indexed by player slot and team.
+ * A registered player is Active until it's finished, e.g. eliminated. Unused slots are Inactive.
+ * Alive players and remaining teams are counted incrementally, so aggregate queries don't scan the players.
+ */
+class TRICKYGAMEMODE_API FTrickyParticipantRegistry
+{
+public:
+	/**
+	 * Registers an active player in the slot.
+	 *
+	 * @param Team Index of the team, INDEX_NONE if the player doesn't belong to a team.
+	 */
+	void AddPlayer(const int32 Slot, const int32 Team = INDEX_NONE);
+
+	bool RemovePlayer(const int32 Slot);
+
+	bool SetPlayerTeam(const int32 Slot, const int32 Team);
+
+	/**
+	 * Finishes the player with the result. The team is finished when its last alive player is finished.
+	 *
+	 * @return True if the player was alive.
+	 */
+	bool FinishPlayer(const int32 Slot, const EGameResult Result);
+
+	/**
+	 * Makes all registered players and teams active again.
+	 */
+	void ResetResults();
+
+	ETrickyGameState GetPlayerState(const int32 Slot) const;
+
+	EGameResult GetPlayerResult(const int32 Slot) const;
+
+	int32 GetPlayerTeam(const int32 Slot) const;
+
+	FORCEINLINE int32 GetSlotsNum() const { return PlayerStates.Num(); }
+
+	FORCEINLINE bool IsPlayerAlive(const int32 Slot) const
+	{
+		return GetPlayerState(Slot) == ETrickyGameState::Active;
+	}
+
+	FORCEINLINE int32 GetAliveNum() const { return AliveNum; }
+
+	FORCEINLINE int32 GetTeamsRemainingNum() const { return TeamsRemainingNum; }
+
+	int32 GetTeamAliveNum(const int32 Team) const;
+
+	/**
+	 * @return Finished if all players of the team are finished, Active if some are alive, Inactive if it's empty.
+	 */
+	ETrickyGameState GetTeamState(const int32 Team) const;
+
+	EGameResult GetTeamResult(const int32 Team) const;
+
+private:
+	TArray<ETrickyGameState> PlayerStates;
+
+	TArray<EGameResult> PlayerResults;
+
+	TArray<int32> PlayerTeams;
+
+	TArray<int32> TeamPlayersNums;
+
+	TArray<int32> TeamAliveNums;
+
+	TArray<EGameResult> TeamResults;
+
+	int32 AliveNum = 0;
+
+	int32 TeamsRemainingNum = 0;
+
+	void AddAlive(const int32 Slot);
+
+	void RemoveAlive(const int32 Slot, const EGameResult Result);
+};
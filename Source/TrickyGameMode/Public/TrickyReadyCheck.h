@@ -0,0 +1,73 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TrickyReadyCheck.generated.h"
+
+/**
+ * Connected and ready players packed into bitsets indexed by player slot.
+ * The numbers of connected and ready players are updated incrementally, so the quorum is checked in O(1).
+ * Replicated as part of TrickyGameStateBase, only the changed words of the masks are sent.
+ */
+USTRUCT(BlueprintType)
+struct TRICKYGAMEMODE_API FTrickyReadyCheck
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<uint32> ConnectedMask;
+
+	UPROPERTY()
+	TArray<uint32> ReadyMask;
+
+	UPROPERTY(BlueprintReadOnly, Category=ReadyCheck)
+	int32 ConnectedNum = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category=ReadyCheck)
+	int32 ReadyNum = 0;
+
+	/**
+	 * Occupies the lowest free slot.
+	 *
+	 * @return The slot of the added player.
+	 */
+	int32 AddPlayer();
+
+	/**
+	 * Frees the slot and clears its ready flag.
+	 *
+	 * @return True if the slot was occupied.
+	 */
+	bool RemovePlayer(const int32 Slot);
+
+	/**
+	 * @return True if the ready flag of the slot changed.
+	 */
+	bool SetReady(const int32 Slot, const bool bIsReady);
+
+	/**
+	 * Clears the ready flags of all players, e.g. when a new preparation starts.
+	 */
+	void ResetReady();
+
+	bool IsConnected(const int32 Slot) const { return GetBit(ConnectedMask, Slot); }
+
+	bool IsReady(const int32 Slot) const { return GetBit(ReadyMask, Slot); }
+
+	/**
+	 * @return Number of ready players required to reach the quorum, at least 1.
+	 */
+	int32 GetRequiredNum(const float Quorum) const;
+
+	bool HasQuorum(const float Quorum) const;
+
+	bool operator==(const FTrickyReadyCheck& Other) const;
+
+	bool operator!=(const FTrickyReadyCheck& Other) const { return !(*this == Other); }
+
+private:
+	static bool GetBit(const TArray<uint32>& Mask, const int32 Slot);
+
+	static void SetBit(TArray<uint32>& Mask, const int32 Slot, const bool bValue);
+};
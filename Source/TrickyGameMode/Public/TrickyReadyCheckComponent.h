@@ -0,0 +1,52 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "TrickyReadyCheckComponent.generated.h"
+
+/**
+ * Reports the readiness of a player to TrickyGameModeBase when its ready check is enabled.
+ * Add it to the player state class, the game mode assigns its player slot on login.
+ */
+UCLASS(ClassGroup=(TrickyGameMode), meta=(BlueprintSpawnableComponent))
+class TRICKYGAMEMODE_API UTrickyReadyCheckComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UTrickyReadyCheckComponent();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/**
+	 * Reports the readiness of the owning player to the server.
+	 * The request is sent only when the value differs from the last requested one.
+	 */
+	UFUNCTION(BlueprintCallable, Category=ReadyCheck)
+	void SetReady(const bool bIsReady);
+
+	/**
+	 * @return True if the server confirmed the player is ready.
+	 */
+	UFUNCTION(BlueprintPure, Category=ReadyCheck)
+	bool IsReady() const;
+
+	UFUNCTION(BlueprintGetter, Category=ReadyCheck)
+	FORCEINLINE int32 GetPlayerSlot() const { return PlayerSlot; }
+
+	/**
+	 * @warning Must be called only on the server.
+	 */
+	void SetPlayerSlot(const int32 Slot);
+
+private:
+	UPROPERTY(Replicated, BlueprintGetter=GetPlayerSlot, Category=ReadyCheck)
+	int32 PlayerSlot = INDEX_NONE;
+
+	bool bIsReadyRequested = false;
+
+	UFUNCTION(Server, Reliable)
+	void ServerSetReady(const bool bIsReady);
+};
@@ -0,0 +1,136 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+#include "TrickyRematchResettable.generated.h"
+
+class AActor;
+
+// This class does not need to be modified.
+UINTERFACE(MinimalAPI, Blueprintable)
+class UTrickyRematchResettable : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Interface of actors which return to their initial state when TrickyGameModeBase starts a rematch.
+ * The actors must be registered with TrickyGameModeLibrary::RegisterForRematch.
+ */
+class TRICKYGAMEMODE_API ITrickyRematchResettable
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Resets the actor on the game thread when a rematch starts.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category=Rematch)
+	void ResetForRematch();
+
+	virtual void ResetForRematch_Implementation() {}
+
+	/**
+	 * Resets the state which doesn't touch other UObjects, e.g. plain arrays and counters.
+	 * It's called before ResetForRematch, from worker threads if SupportsParallelReset returns true.
+	 */
+	virtual void ResetNativeState() {}
+
+	/**
+	 * Queried once per class on its default object.
+	 */
+	virtual bool SupportsParallelReset() const { return false; }
+};
+
+/**
+ * Actors implementing TrickyRematchResettable, grouped into contiguous arrays per class.
+ * The actors of a class are reset together, so the same reset code runs over them back to back.
+ */
+class TRICKYGAMEMODE_API FTrickyRematchRegistry
+{
+public:
+	/**
+	 * While the actors are being reset, the registration is applied after the reset ends.
+	 *
+	 * @return True if the actor implements TrickyRematchResettable and wasn't registered yet.
+	 */
+	bool Register(AActor* Actor);
+
+	/**
+	 * While the actors are being reset, the actor is still reset if it's valid, and removed after the reset ends.
+	 */
+	bool Unregister(AActor* Actor);
+
+	/**
+	 * Resets the native state of all registered actors, in parallel where the class supports it,
+	 * then calls ResetForRematch on the game thread.
+	 * Actors which were destroyed or became invalid are skipped and removed.
+	 */
+	void ResetAll();
+
+	int32 Num() const;
+
+	void Reset();
+
+private:
+	struct FClassBucket
+	{
+		const UClass* Class = nullptr;
+
+		TArray<TWeakObjectPtr<AActor>> Actors;
+
+		/**
+		 * Keys of Actors, they identify the actors even after they're destroyed.
+		 */
+		TArray<FObjectKey> ActorKeys;
+
+		/**
+		 * Index of every actor in Actors.
+		 */
+		TMap<FObjectKey, int32> ActorIndices;
+
+		bool bSupportsParallelReset = false;
+
+		void Add(AActor* Actor);
+
+		bool Remove(const FObjectKey& ActorKey);
+	};
+
+	struct FPendingChange
+	{
+		TWeakObjectPtr<AActor> Actor;
+
+		FObjectKey ActorKey;
+
+		bool bIsRegistered = false;
+	};
+
+	TArray<FClassBucket> Buckets;
+
+	TMap<const UClass*, int32> BucketIndices;
+
+	/**
+	 * Copy of the actors of the bucket being reset, so ResetForRematch can't change the array being iterated.
+	 */
+	TArray<TWeakObjectPtr<AActor>> ResetActors;
+
+	/**
+	 * Native interfaces of the bucket being reset, resolved on the game thread.
+	 */
+	TArray<ITrickyRematchResettable*> Resettables;
+
+	/**
+	 * Registrations and unregistrations made by the actors while they were being reset.
+	 */
+	TArray<FPendingChange> PendingChanges;
+
+	bool bIsResetting = false;
+
+	FClassBucket& FindOrAddBucket(const UClass* Class);
+
+	void ApplyPendingChanges();
+};
@@ -0,0 +1,56 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameStateControllerInterface.h"
+#include "TrickyServerTickRate.generated.h"
+
+/**
+ * Target tick rates of a dedicated server for every game state and inactivity reason.
+ * 0 keeps the NetServerMaxTickRate of the net driver.
+ */
+USTRUCT(BlueprintType)
+struct TRICKYGAMEMODE_API FTrickyServerTickRates
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=ServerTickRate, meta=(ClampMin=0, UIMin=0))
+	int32 Active = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=ServerTickRate, meta=(ClampMin=0, UIMin=0))
+	int32 Preparation = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=ServerTickRate, meta=(ClampMin=0, UIMin=0))
+	int32 Paused = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=ServerTickRate, meta=(ClampMin=0, UIMin=0))
+	int32 Cutscene = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=ServerTickRate, meta=(ClampMin=0, UIMin=0))
+	int32 Transition = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=ServerTickRate, meta=(ClampMin=0, UIMin=0))
+	int32 Custom = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=ServerTickRate, meta=(ClampMin=0, UIMin=0))
+	int32 Finished = 0;
+
+	/**
+	 * The lowest hibernation tick rate. The handshake is processed once per frame, so it bounds the join latency.
+	 */
+	static constexpr int32 MinHibernationTickRate = 10;
+
+	/**
+	 * Tick rate while the game is inactive, no players are connected and no login is in progress.
+	 * The handshake before a connection is opened is processed at this rate, so every round trip of it
+	 * may wait for one frame. Values below MinHibernationTickRate are raised to it, 0 disables hibernation.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=ServerTickRate, meta=(ClampMin=0, UIMin=0))
+	int32 Hibernation = 0;
+
+	/**
+	 * @return Target tick rate, 0 if the default rate must be used.
+	 */
+	int32 GetTickRate(const ETrickyGameState State, const EGameInactivityReason Reason, const bool bHasPlayers) const;
+};
@@ -0,0 +1,49 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TrickyTimerStamp.h"
+
+/**
+ * Keeps the time stamps of the game session in double precision.
+ * Elapsed and remaining time are computed from the stamps and the current world time,
+ * so the queries don't touch the timer manager. The timer manager is only used to trigger the end of the timers.
+ */
+struct TRICKYGAMEMODE_API FTrickySessionClock
+{
+	/**
+	 * World time when the current state or inactivity reason was entered.
+	 */
+	double PhaseStartTime = 0.0;
+
+	FTrickyTimerStamp PreparationTimer;
+
+	/**
+	 * Its duration is 0 if the session isn't time limited, in this case it measures the time since the last start.
+	 */
+	FTrickyTimerStamp GameTimer;
+
+	FORCEINLINE void StartPhase(const double Now) { PhaseStartTime = Now; }
+
+	FORCEINLINE double GetPhaseElapsed(const double Now) const { return FMath::Max(Now - PhaseStartTime, 0.0); }
+
+	FORCEINLINE double GetGameElapsed(const double Now) const { return GameTimer.GetElapsed(Now); }
+
+	/**
+	 * @return Remaining time of a time-limited session, or elapsed time if the session isn't limited.
+	 */
+	FORCEINLINE double GetGameRemaining(const double Now) const
+	{
+		return GameTimer.IsLimited() ? GameTimer.GetRemaining(Now) : GameTimer.GetElapsed(Now);
+	}
+
+	FORCEINLINE double GetPreparationElapsed(const double Now) const { return PreparationTimer.GetElapsed(Now); }
+
+	FORCEINLINE double GetPreparationRemaining(const double Now) const { return PreparationTimer.GetRemaining(Now); }
+
+	void Reset()
+	{
+		*this = FTrickySessionClock();
+	}
+};
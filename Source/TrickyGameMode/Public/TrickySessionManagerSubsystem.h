@@ -0,0 +1,240 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameStateControllerInterface.h"
+#include "TrickyTimerStamp.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TrickySessionManagerSubsystem.generated.h"
+
+/**
+ * Identifies a session of TrickySessionManagerSubsystem. Ids of destroyed sessions are never valid again.
+ */
+USTRUCT(BlueprintType)
+struct TRICKYGAMEMODE_API FTrickySessionId
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=GameState)
+	int32 Index = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category=GameState)
+	int32 Serial = 0;
+
+	FORCEINLINE bool IsValid() const { return Index != INDEX_NONE; }
+
+	bool operator==(const FTrickySessionId& Other) const
+	{
+		return Index == Other.Index && Serial == Other.Serial;
+	}
+
+	bool operator!=(const FTrickySessionId& Other) const { return !(*this == Other); }
+
+	friend uint32 GetTypeHash(const FTrickySessionId& Id)
+	{
+		return HashCombine(::GetTypeHash(Id.Index), ::GetTypeHash(Id.Serial));
+	}
+};
+
+/**
+ * Settings of a session, they have the same meaning as the properties of TrickyGameModeBase.
+ */
+USTRUCT(BlueprintType)
+struct TRICKYGAMEMODE_API FTrickySessionSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=GameState)
+	EGameInactivityReason InitialInactivityReason = EGameInactivityReason::Transition;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=GameState, meta=(ClampMin="0.0", UIMin="0.0"))
+	float PreparationDuration = 3.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=GameState)
+	bool bIsSessionTimeLimited = false;
+
+	UPROPERTY(EditAnywhere,
+		BlueprintReadWrite,
+		Category=GameState,
+		meta=(ClampMin="1.0", UIMin="1.0", EditCondition="bIsSessionTimeLimited"))
+	float GameDuration = 120.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=GameState, meta=(EditCondition="bIsSessionTimeLimited"))
+	EGameResult DefaultTimeOverResult = EGameResult::Win;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnSessionTransitionSignature,
+                                     const FTrickySessionId&,
+                                     const FTrickyGameStateTransition&);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSessionStateChangedDynamicSignature,
+                                             const FTrickySessionId&,
+                                             SessionId,
+                                             const ETrickyGameState,
+                                             NewState);
+
+/**
+ * Runs many lightweight game state machines (e.g. rooms of a dedicated server) in one world.
+ * Every session has the same semantics as TrickyGameModeBase, but doesn't need its own actor and timers:
+ * the sessions are stored as structure of arrays and their timers are advanced by a single batched tick.
+ */
+UCLASS()
+class TRICKYGAMEMODE_API UTrickySessionManagerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	virtual ETickableTickType GetTickableTickType() const override;
+
+	virtual bool IsTickable() const override;
+
+	static UTrickySessionManagerSubsystem* Get(const UObject* WorldContextObject);
+
+	/**
+	 * Triggered once per completed transition of a session.
+	 */
+	FOnSessionTransitionSignature OnSessionTransitionNative;
+
+	/**
+	 * Triggered when the state of a session changed.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnSessionStateChangedDynamicSignature OnSessionStateChanged;
+
+	/**
+	 * Creates a session in the initial inactivity reason of the settings.
+	 * If it's Preparation, the preparation timer starts immediately.
+	 */
+	FTrickySessionId CreateSession(const FTrickySessionSettings& SessionSettings);
+
+	bool DestroySession(const FTrickySessionId& SessionId);
+
+	FORCEINLINE bool IsSessionValid(const FTrickySessionId& SessionId) const
+	{
+		return GetIndex(SessionId) != INDEX_NONE;
+	}
+
+	FORCEINLINE int32 GetSessionsNum() const { return SessionsNum; }
+
+	bool StartGame(const FTrickySessionId& SessionId);
+
+	bool FinishGame(const FTrickySessionId& SessionId, const EGameResult Result);
+
+	bool StopGame(const FTrickySessionId& SessionId, const EGameInactivityReason Reason);
+
+	bool ChangeInactivityReason(const FTrickySessionId& SessionId, const EGameInactivityReason Reason);
+
+	bool StartPreparation(const FTrickySessionId& SessionId);
+
+	bool StartCutscene(const FTrickySessionId& SessionId);
+
+	bool StartTransition(const FTrickySessionId& SessionId);
+
+	ETrickyGameState GetGameState(const FTrickySessionId& SessionId) const;
+
+	EGameResult GetGameResult(const FTrickySessionId& SessionId) const;
+
+	EGameInactivityReason GetGameInactivityReason(const FTrickySessionId& SessionId) const;
+
+	float GetGameElapsedTime(const FTrickySessionId& SessionId) const;
+
+	/**
+	 * @return Remaining time of a time-limited session, or elapsed time if the session isn't limited.
+	 */
+	float GetGameRemainingTime(const FTrickySessionId& SessionId) const;
+
+	float GetPreparationRemainingTime(const FTrickySessionId& SessionId) const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/**
+	 * A deadline scheduled in the queue. It's stale if the session was destroyed or its deadline changed.
+	 */
+	struct FScheduledDeadline
+	{
+		double Deadline = 0.0;
+
+		int32 Index = INDEX_NONE;
+
+		int32 Serial = 0;
+
+		bool operator<(const FScheduledDeadline& Other) const
+		{
+			if (Deadline != Other.Deadline)
+			{
+				return Deadline < Other.Deadline;
+			}
+
+			return Index != Other.Index ? Index < Other.Index : Serial < Other.Serial;
+		}
+	};
+
+	/**
+	 * Structure of arrays indexed by FTrickySessionId::Index.
+	 */
+	TArray<int32> Serials;
+
+	TBitArray<> AliveSessions;
+
+	TArray<ETrickyGameState> States;
+
+	TArray<ETrickyGameState> LastStates;
+
+	TArray<EGameInactivityReason> InactivityReasons;
+
+	TArray<EGameResult> Results;
+
+	TArray<FTrickySessionSettings> Settings;
+
+	TArray<FTrickyTimerStamp> PreparationTimers;
+
+	TArray<FTrickyTimerStamp> GameTimers;
+
+	/**
+	 * World time when the earliest running timer of the session ends.
+	 */
+	TArray<double> Deadlines;
+
+	/**
+	 * Min-heap of the scheduled deadlines, the tick pops only the due ones. Stale entries are skipped when popped.
+	 */
+	TArray<FScheduledDeadline> DeadlineQueue;
+
+	TArray<int32> FreeIndices;
+
+	int32 SessionsNum = 0;
+
+	/**
+	 * Number of sessions with a finite deadline, the subsystem ticks only when it's positive.
+	 */
+	int32 ScheduledNum = 0;
+
+	TArray<int32> DueSessions;
+
+	int32 GetIndex(const FTrickySessionId& SessionId) const;
+
+	double GetTime() const;
+
+	FTrickySessionId MakeId(const int32 Index) const { return FTrickySessionId{Index, Serials[Index]}; }
+
+	void SetState(const int32 Index, const ETrickyGameState NewState);
+
+	void SetInactivityReason(const int32 Index, const EGameInactivityReason NewReason);
+
+	void StartPreparationTimer(const int32 Index);
+
+	void UpdateDeadline(const int32 Index);
+
+	FTrickyGameStateTransition BeginTransition(const int32 Index) const;
+
+	void EndTransition(const int32 Index, FTrickyGameStateTransition& Transition);
+};
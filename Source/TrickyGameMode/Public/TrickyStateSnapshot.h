@@ -0,0 +1,93 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameStateControllerInterface.h"
+#include "TrickySessionClock.h"
+#include <atomic>
+
+/**
+ * A consistent copy of the game mode state which can be read from any thread.
+ */
+struct TRICKYGAMEMODE_API FTrickyGameStateSnapshot
+{
+	ETrickyGameState State = ETrickyGameState::Inactive;
+
+	ETrickyGameState LastState = ETrickyGameState::Inactive;
+
+	EGameInactivityReason InactivityReason = EGameInactivityReason::None;
+
+	EGameResult Result = EGameResult::None;
+
+	/**
+	 * Incremented every time the game mode publishes a changed state or timer.
+	 */
+	uint32 Sequence = 0;
+
+	/**
+	 * Session clock at the moment of publishing. Filled only by FTrickyStateSnapshotPublisher::Read.
+	 */
+	FTrickySessionClock Clock;
+
+	double PublishWorldTime = 0.0;
+
+	double PublishPlatformTime = 0.0;
+
+	FORCEINLINE bool IsActive() const { return State == ETrickyGameState::Active; }
+
+	/**
+	 * Estimates the current world time from the platform time elapsed since publishing.
+	 * @warning Doesn't account for time dilation and world pause.
+	 */
+	double GetEstimatedWorldTime() const
+	{
+		return PublishWorldTime + FMath::Max(FPlatformTime::Seconds() - PublishPlatformTime, 0.0);
+	}
+};
+
+/**
+ * Publishes the game mode state for readers on other threads, e.g. async AI tasks, physics callbacks or audio.
+ * The state, last state, inactivity reason, result and sequence number are packed into a single atomic word,
+ * so ReadState is wait-free. The session clock is published into a ring of slots indexed by the sequence,
+ * Read copies the slot of the sampled word and retries only if the ring wrapped around during the copy.
+ * Publish must be called only on the game thread.
+ */
+class TRICKYGAMEMODE_API FTrickyStateSnapshotPublisher
+{
+public:
+	void Publish(const FTrickyGameStateSnapshot& Snapshot);
+
+	/**
+	 * Samples the state without the session clock. Wait-free.
+	 */
+	FTrickyGameStateSnapshot ReadState() const;
+
+	/**
+	 * Samples the state together with the session clock it was published with.
+	 */
+	FTrickyGameStateSnapshot Read() const;
+
+	FORCEINLINE uint32 GetSequence() const
+	{
+		return static_cast<uint32>(StateWord.load(std::memory_order_acquire) >> 32);
+	}
+
+private:
+	static constexpr int32 SlotsNum = 16;
+
+	static constexpr int32 SlotValuesNum = 11;
+
+	struct FClockSlot
+	{
+		std::atomic<double> Values[SlotValuesNum];
+	};
+
+	std::atomic<uint64> StateWord{0};
+
+	FClockSlot Slots[SlotsNum];
+
+	static uint64 PackState(const FTrickyGameStateSnapshot& Snapshot, const uint32 Sequence);
+
+	static void UnpackState(const uint64 Word, FTrickyGameStateSnapshot& OutSnapshot);
+};
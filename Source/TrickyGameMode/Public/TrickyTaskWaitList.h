@@ -0,0 +1,61 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+
+/**
+ * A pending wait resolved on the game thread. The event is triggered exactly once, when the wait completes or
+ * is cancelled, so tasks depending on it are never left waiting.
+ */
+struct TRICKYGAMEMODE_API FTrickyTaskWait
+{
+	FTrickyTaskWait() : Event(TEXT("TrickyTaskWait")) {}
+
+	UE::Tasks::FTaskEvent Event;
+
+	/**
+	 * True if the awaited condition was met, false if the wait was cancelled. Written before Event is triggered.
+	 */
+	bool bIsResolved = false;
+
+	/**
+	 * Removes the listener which resolves the wait. Called on the game thread when the wait completes.
+	 */
+	TFunction<void()> Unsubscribe;
+};
+
+/**
+ * Keeps the pending waits of an owner, so they can be cancelled when the owner ends play.
+ * All functions must be called on the game thread; the returned tasks can be used from any thread.
+ */
+class TRICKYGAMEMODE_API FTrickyTaskWaitList
+{
+public:
+	using FWaitRef = TSharedRef<FTrickyTaskWait, ESPMode::ThreadSafe>;
+
+	~FTrickyTaskWaitList();
+
+	FWaitRef Add();
+
+	/**
+	 * @return A task which completes after the wait with true if it was resolved and false if it was cancelled.
+	 */
+	static UE::Tasks::TTask<bool> MakeTask(const FWaitRef& Wait);
+
+	/**
+	 * Unsubscribes the wait and triggers its event. Does nothing if the wait was already completed.
+	 */
+	void Complete(const FWaitRef& Wait, const bool bIsResolved);
+
+	/**
+	 * Completes all pending waits as cancelled.
+	 */
+	void CancelAll();
+
+	FORCEINLINE int32 Num() const { return Waits.Num(); }
+
+private:
+	TArray<FWaitRef> Waits;
+};
@@ -0,0 +1,181 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameStateControllerInterface.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+#include "TrickyTickPolicy.generated.h"
+
+UENUM(BlueprintType)
+enum class ETrickyTickMode : uint8
+{
+	Full,
+	Reduced,
+	Disabled
+};
+
+/**
+ * Defines how an object ticks in every game state and inactivity reason.
+ */
+USTRUCT(BlueprintType)
+struct TRICKYGAMEMODE_API FTrickyTickPolicy
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=TickPolicy)
+	ETrickyTickMode Active = ETrickyTickMode::Full;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=TickPolicy)
+	ETrickyTickMode Preparation = ETrickyTickMode::Full;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=TickPolicy)
+	ETrickyTickMode Paused = ETrickyTickMode::Disabled;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=TickPolicy)
+	ETrickyTickMode Cutscene = ETrickyTickMode::Reduced;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=TickPolicy)
+	ETrickyTickMode Transition = ETrickyTickMode::Disabled;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=TickPolicy)
+	ETrickyTickMode Custom = ETrickyTickMode::Full;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=TickPolicy)
+	ETrickyTickMode Finished = ETrickyTickMode::Reduced;
+
+	/**
+	 * Tick interval in the Reduced mode. The original interval is kept if it's longer.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=TickPolicy, meta=(ClampMin=0, UIMin=0))
+	float ReducedTickInterval = 0.5f;
+
+	ETrickyTickMode GetTickMode(const ETrickyGameState State, const EGameInactivityReason Reason) const;
+
+	bool operator==(const FTrickyTickPolicy& Other) const;
+};
+
+DECLARE_DELEGATE_TwoParams(FOnTickModeChangedSignature, const ETrickyTickMode /*TickMode*/, const float /*Interval*/);
+
+/**
+ * Objects which change their tick rate with the game state. Objects are grouped by identical policies, so a transition
+ * only visits the groups whose tick mode changes and applies it to the whole group in one pass.
+ * Actors and components are ticked through their primary tick function, other objects like subsystems
+ * register a delegate which receives the tick mode and the interval.
+ * Delegates may register, unregister or apply a new state while they're invoked, such changes are deferred
+ * until the current pass ends.
+ */
+class TRICKYGAMEMODE_API FTrickyTickPolicyRegistry
+{
+public:
+	/**
+	 * Registers an actor or a component and applies the tick mode of the current state.
+	 * The tick settings are captured when the object leaves the Full mode and restored when it returns to it,
+	 * so the changes made in the Full mode are kept.
+	 *
+	 * @return True if the object is an actor or a component and wasn't registered yet.
+	 */
+	bool Register(UObject* Object, const FTrickyTickPolicy& Policy);
+
+	/**
+	 * Registers a delegate for objects without a primary tick function and invokes it with the current tick mode.
+	 *
+	 * @return A handle which is used to unregister.
+	 */
+	FDelegateHandle Register(const FTrickyTickPolicy& Policy, FOnTickModeChangedSignature&& Delegate);
+
+	/**
+	 * Restores the tick settings the object had before it was throttled.
+	 */
+	bool Unregister(const UObject* Object);
+
+	bool Unregister(const FDelegateHandle Handle);
+
+	/**
+	 * Applies the tick modes of the state to the groups whose mode differs from the previously applied one.
+	 */
+	void Apply(const ETrickyGameState State, const EGameInactivityReason Reason);
+
+	int32 Num() const;
+
+	/**
+	 * Restores the tick settings of all throttled objects and removes them.
+	 */
+	void Reset();
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<UObject> Object;
+
+		FOnTickModeChangedSignature Delegate;
+
+		/**
+		 * Tick settings captured when the entry left the Full mode.
+		 */
+		float FullTickInterval = 0.f;
+
+		bool bIsTickEnabled = true;
+
+		bool bIsThrottled = false;
+
+		/**
+		 * Set when the entry is removed while the registry is applying, the entry is erased after the pass.
+		 */
+		bool bIsRemoved = false;
+	};
+
+	struct FPolicyGroup
+	{
+		FTrickyTickPolicy Policy;
+
+		ETrickyTickMode AppliedMode = ETrickyTickMode::Full;
+
+		TArray<FEntry> Entries;
+	};
+
+	struct FPendingEntry
+	{
+		FTrickyTickPolicy Policy;
+
+		FEntry Entry;
+	};
+
+	TArray<FPolicyGroup> Groups;
+
+	/**
+	 * Entries registered while the registry is applying.
+	 */
+	TArray<FPendingEntry> PendingEntries;
+
+	bool bIsApplying = false;
+
+	/**
+	 * Set when a new state is applied while the registry is applying.
+	 */
+	bool bIsApplyPending = false;
+
+	ETrickyGameState CurrentState = ETrickyGameState::Inactive;
+
+	EGameInactivityReason CurrentReason = EGameInactivityReason::None;
+
+	FPolicyGroup& FindOrAddGroup(const FTrickyTickPolicy& Policy);
+
+	bool IsRegistered(const UObject* Object) const;
+
+	void AddEntry(const FTrickyTickPolicy& Policy, FEntry&& Entry);
+
+	bool RemoveEntry(TFunctionRef<bool(const FEntry&)> Predicate);
+
+	void ApplyCurrentState();
+
+	/**
+	 * Applies the changes deferred while applying until no new ones are made.
+	 */
+	void FinishApplying();
+
+	/**
+	 * @return False if the object of the entry was destroyed.
+	 */
+	static bool ApplyToEntry(FEntry& Entry, const ETrickyTickMode TickMode, const float ReducedTickInterval);
+};
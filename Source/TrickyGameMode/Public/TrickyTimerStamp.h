@@ -0,0 +1,120 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TrickyTimerStamp.generated.h"
+
+/**
+ * Describes a running timer by its start time, duration and pause offset.
+ * Elapsed and remaining time are computed from the current world time, so the stamp is replicated only
+ * when the timer is started, stopped, paused or unpaused.
+ */
+USTRUCT(BlueprintType)
+struct TRICKYGAMEMODE_API FTrickyTimerStamp
+{
+	GENERATED_BODY()
+
+	/**
+	 * World time when the timer started. Negative if the timer isn't active.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category=Timer)
+	double StartTime = -1.0;
+
+	/**
+	 * Duration of the timer in seconds. 0 if the timer isn't limited.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category=Timer)
+	float Duration = 0.f;
+
+	/**
+	 * Accumulated time the timer spent paused.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category=Timer)
+	double PauseOffset = 0.0;
+
+	/**
+	 * World time when the timer was paused. Negative if the timer isn't paused.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category=Timer)
+	double PauseStartTime = -1.0;
+
+	FORCEINLINE bool IsActive() const { return StartTime >= 0.0; }
+
+	FORCEINLINE bool IsPaused() const { return PauseStartTime >= 0.0; }
+
+	FORCEINLINE bool IsLimited() const { return Duration > 0.f; }
+
+	void Start(const double Now, const float InDuration)
+	{
+		StartTime = Now;
+		Duration = InDuration;
+		PauseOffset = 0.0;
+		PauseStartTime = -1.0;
+	}
+
+	void Stop()
+	{
+		*this = FTrickyTimerStamp();
+	}
+
+	bool Pause(const double Now)
+	{
+		if (!IsActive() || IsPaused())
+		{
+			return false;
+		}
+
+		PauseStartTime = Now;
+		return true;
+	}
+
+	bool UnPause(const double Now)
+	{
+		if (!IsActive() || !IsPaused())
+		{
+			return false;
+		}
+
+		PauseOffset += Now - PauseStartTime;
+		PauseStartTime = -1.0;
+		return true;
+	}
+
+	/**
+	 * @return Elapsed time in seconds, -1 if the timer isn't active.
+	 */
+	double GetElapsed(const double Now) const
+	{
+		if (!IsActive())
+		{
+			return -1.0;
+		}
+
+		const double EndTime = IsPaused() ? PauseStartTime : Now;
+		return FMath::Max(EndTime - StartTime - PauseOffset, 0.0);
+	}
+
+	/**
+	 * @return Remaining time in seconds, -1 if the timer isn't active or limited.
+	 */
+	double GetRemaining(const double Now) const
+	{
+		if (!IsActive() || !IsLimited())
+		{
+			return -1.0;
+		}
+
+		return FMath::Max(Duration - GetElapsed(Now), 0.0);
+	}
+
+	bool operator==(const FTrickyTimerStamp& Other) const
+	{
+		return StartTime == Other.StartTime
+			&& Duration == Other.Duration
+			&& PauseOffset == Other.PauseOffset
+			&& PauseStartTime == Other.PauseStartTime;
+	}
+
+	bool operator!=(const FTrickyTimerStamp& Other) const { return !(*this == Other); }
+};
@@ -0,0 +1,207 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameStateControllerInterface.h"
+#include "TrickyTransitionDispatcher.generated.h"
+
+/**
+ * Describes which transitions of the game state machine a listener is interested in.
+ */
+USTRUCT(BlueprintType)
+struct TRICKYGAMEMODE_API FTrickyTransitionFilter
+{
+	GENERATED_BODY()
+
+	/**
+	 * States the transition may start from.
+	 */
+	UPROPERTY(EditAnywhere,
+		BlueprintReadWrite,
+		Category=GameState,
+		meta=(Bitmask, BitmaskEnum="/Script/TrickyGameMode.ETrickyGameState"))
+	int32 FromStateMask = AllStates;
+
+	/**
+	 * States the transition may end in.
+	 */
+	UPROPERTY(EditAnywhere,
+		BlueprintReadWrite,
+		Category=GameState,
+		meta=(Bitmask, BitmaskEnum="/Script/TrickyGameMode.ETrickyGameState"))
+	int32 ToStateMask = AllStates;
+
+	/**
+	 * Inactivity reasons of the inactive side of the transition.
+	 * Transitions without an inactive side, e.g. Active -> Finished, have the None reason.
+	 */
+	UPROPERTY(EditAnywhere,
+		BlueprintReadWrite,
+		Category=GameState,
+		meta=(Bitmask, BitmaskEnum="/Script/TrickyGameMode.EGameInactivityReason"))
+	int32 ReasonMask = AllReasons;
+
+	static constexpr int32 AllStates = 0x7;
+
+	static constexpr int32 AllReasons = 0x3F;
+
+	static constexpr int32 ToMask(const ETrickyGameState State) { return 1 << static_cast<uint8>(State); }
+
+	static constexpr int32 ToMask(const EGameInactivityReason Reason) { return 1 << static_cast<uint8>(Reason); }
+
+	/**
+	 * Creates a filter for a single edge of the state machine.
+	 */
+	static FTrickyTransitionFilter MakeEdge(const ETrickyGameState From, const ETrickyGameState To)
+	{
+		FTrickyTransitionFilter Filter;
+		Filter.FromStateMask = ToMask(From);
+		Filter.ToStateMask = ToMask(To);
+		return Filter;
+	}
+
+	/**
+	 * Creates a filter for any transition ending in the given state.
+	 */
+	static FTrickyTransitionFilter MakeTo(const ETrickyGameState To)
+	{
+		FTrickyTransitionFilter Filter;
+		Filter.ToStateMask = ToMask(To);
+		return Filter;
+	}
+
+	FTrickyTransitionFilter& WithReason(const EGameInactivityReason Reason)
+	{
+		ReasonMask = ToMask(Reason);
+		return *this;
+	}
+
+	FORCEINLINE bool Matches(const FTrickyGameStateTransition& Transition) const
+	{
+		return (FromStateMask & ToMask(Transition.FromState))
+			&& (ToStateMask & ToMask(Transition.ToState))
+			&& (ReasonMask & ToMask(Transition.GetInactivityReason()));
+	}
+};
+
+/**
+ * Defines how a transition listener is invoked.
+ */
+USTRUCT(BlueprintType)
+struct TRICKYGAMEMODE_API FTrickyTransitionListenerOptions
+{
+	GENERATED_BODY()
+
+	/**
+	 * Listeners with higher priority are invoked first.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=GameState)
+	int32 Priority = 0;
+
+	/**
+	 * If true, the listener may be invoked on one of the following frames, within the deferred listeners budget.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=GameState)
+	bool bMayDefer = false;
+};
+
+/**
+ * Invokes transition listeners registered for specific edges of the state machine.
+ * Listeners are stored per from/to edge, so a transition only visits the listeners of its edge.
+ * Deferrable listeners are queued and invoked by DispatchDeferred over the following frames.
+ */
+class TRICKYGAMEMODE_API FTrickyTransitionDispatcher
+{
+public:
+	/**
+	 * Registers a listener for all edges allowed by the filter.
+	 *
+	 * @return A handle which is used to unsubscribe.
+	 */
+	FDelegateHandle Subscribe(const FTrickyTransitionFilter& Filter,
+	                          FOnGameStateTransitionSignature::FDelegate&& Delegate,
+	                          const FTrickyTransitionListenerOptions& Options = FTrickyTransitionListenerOptions());
+
+	/**
+	 * Removes the listener from all edges.
+	 *
+	 * @return True if the listener was found.
+	 */
+	bool Unsubscribe(const FDelegateHandle Handle);
+
+	/**
+	 * Invokes the listeners registered for the edge of the transition which accept its inactivity reason.
+	 */
+	void Dispatch(const FTrickyGameStateTransition& Transition);
+
+	/**
+	 * Invokes queued deferrable listeners until the budget runs out. At least one listener is invoked per call.
+	 *
+	 * @return True if there are still queued listeners.
+	 */
+	bool DispatchDeferred(const double BudgetSeconds);
+
+	FORCEINLINE bool HasDeferredListeners() const { return DeferredHead < DeferredCalls.Num(); }
+
+	void Reset();
+
+private:
+	struct FListener
+	{
+		FDelegateHandle Handle;
+
+		int32 ReasonMask = FTrickyTransitionFilter::AllReasons;
+
+		int32 Priority = 0;
+
+		bool bMayDefer = false;
+
+		FOnGameStateTransitionSignature::FDelegate Delegate;
+	};
+
+	struct FDeferredCall
+	{
+		FDelegateHandle Handle;
+
+		FOnGameStateTransitionSignature::FDelegate Delegate;
+
+		FTrickyGameStateTransition Transition;
+	};
+
+	struct FPendingListener
+	{
+		FTrickyTransitionFilter Filter;
+
+		FListener Listener;
+	};
+
+	static constexpr int32 StatesNum = 3;
+
+	TArray<FListener> Edges[StatesNum * StatesNum];
+
+	/**
+	 * Listeners subscribed during a dispatch, they're added when it ends.
+	 */
+	TArray<FPendingListener> PendingListeners;
+
+	/**
+	 * Queue of deferrable listeners, the calls before DeferredHead were already made.
+	 */
+	TArray<FDeferredCall> DeferredCalls;
+
+	int32 DeferredHead = 0;
+
+	int32 DispatchDepth = 0;
+
+	bool bHasUnboundListeners = false;
+
+	static FORCEINLINE int32 GetEdgeIndex(const ETrickyGameState From, const ETrickyGameState To)
+	{
+		return static_cast<int32>(From) * StatesNum + static_cast<int32>(To);
+	}
+
+	void AddListener(const FTrickyTransitionFilter& Filter, const FListener& Listener);
+
+	void FlushPendingChanges();
+};
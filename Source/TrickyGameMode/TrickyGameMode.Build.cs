@@ -26,6 +26,7 @@ public class TrickyGameMode : ModuleRules
 			new string[]
 			{
 				"Core",
+				"FieldNotification",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -36,6 +37,8 @@ public class TrickyGameMode : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"NetCore",
+				"TraceLog",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
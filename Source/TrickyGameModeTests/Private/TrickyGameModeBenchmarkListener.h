@@ -0,0 +1,22 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameStateControllerInterface.h"
+#include "TrickyGameModeBenchmarkListener.generated.h"
+
+/**
+ * A listener of the dynamic delegates used by the benchmark.
+ */
+UCLASS(Transient)
+class UTrickyGameModeBenchmarkListener : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION()
+	void HandleGameStateChanged(const ETrickyGameState NewState) { ++CallsNum; }
+
+	int32 CallsNum = 0;
+};
@@ -0,0 +1,334 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyGameModeBase.h"
+#include "TrickyGameModeBenchmarkListener.h"
+#include "TrickyGameModeLibrary.h"
+#include "TrickyHeadlessWorld.h"
+#include "TrickyTransitionDispatcher.h"
+#include "Dom/JsonObject.h"
+#include "Logging/LogScopedVerbosityOverride.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace TrickyGameModeBenchmark
+{
+	static constexpr int32 RepetitionsNum = 5;
+
+	static constexpr int32 ListenersNums[] = {1, 100, 10000};
+
+	struct FResult
+	{
+		FString Name;
+
+		int32 ListenersNum = 0;
+
+		int64 OperationsNum = 0;
+
+		double MedianNs = 0.0;
+
+		double MinNs = 0.0;
+	};
+
+	/**
+	 * Runs the function Iterations times per repetition and stores the median and the best time of one operation.
+	 */
+	template <typename FunctionType>
+	static void Measure(TArray<FResult>& Results,
+	                    const FString& Name,
+	                    const int32 ListenersNum,
+	                    const int32 Iterations,
+	                    const int32 OperationsPerIteration,
+	                    FunctionType&& Function)
+	{
+		TArray<double> Samples;
+		Samples.Reserve(RepetitionsNum);
+
+		for (int32 Index = 0; Index < FMath::Max(Iterations / 10, 1); ++Index)
+		{
+			Function();
+		}
+
+		for (int32 Repetition = 0; Repetition < RepetitionsNum; ++Repetition)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+
+			for (int32 Index = 0; Index < Iterations; ++Index)
+			{
+				Function();
+			}
+
+			const double Duration = FPlatformTime::Seconds() - StartTime;
+			Samples.Add(Duration * 1e9 / (static_cast<double>(Iterations) * OperationsPerIteration));
+		}
+
+		Samples.Sort();
+
+		FResult& Result = Results.AddDefaulted_GetRef();
+		Result.Name = Name;
+		Result.ListenersNum = ListenersNum;
+		Result.OperationsNum = static_cast<int64>(Iterations) * OperationsPerIteration * RepetitionsNum;
+		Result.MedianNs = Samples[RepetitionsNum / 2];
+		Result.MinNs = Samples[0];
+	}
+
+	static bool SaveResults(const TArray<FResult>& Results, const int32 Iterations, const FString& OutputPath)
+	{
+		const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+		Root->SetStringField(TEXT("engineVersion"), FEngineVersion::Current().ToString());
+		Root->SetStringField(TEXT("buildVersion"), FApp::GetBuildVersion());
+		Root->SetStringField(TEXT("buildConfiguration"), LexToString(FApp::GetBuildConfiguration()));
+		Root->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+		Root->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+		Root->SetNumberField(TEXT("iterations"), Iterations);
+		Root->SetNumberField(TEXT("repetitions"), RepetitionsNum);
+
+		TArray<TSharedPtr<FJsonValue>> ResultValues;
+
+		for (const FResult& Result : Results)
+		{
+			const TSharedRef<FJsonObject> ResultObject = MakeShared<FJsonObject>();
+			ResultObject->SetStringField(TEXT("name"), Result.Name);
+			ResultObject->SetNumberField(TEXT("listeners"), Result.ListenersNum);
+			ResultObject->SetNumberField(TEXT("operations"), static_cast<double>(Result.OperationsNum));
+			ResultObject->SetNumberField(TEXT("medianNs"), Result.MedianNs);
+			ResultObject->SetNumberField(TEXT("minNs"), Result.MinNs);
+			ResultObject->SetNumberField(TEXT("opsPerSecond"), Result.MedianNs > 0.0 ? 1e9 / Result.MedianNs : 0.0);
+			ResultValues.Add(MakeShared<FJsonValueObject>(ResultObject));
+		}
+
+		Root->SetArrayField(TEXT("results"), ResultValues);
+
+		FString Output;
+		const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+
+		if (!FJsonSerializer::Serialize(Root, Writer))
+		{
+			return false;
+		}
+
+		return FFileHelper::SaveStringToFile(Output, *OutputPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+	}
+
+	/**
+	 * Measures transitions, library getters and timers of a game mode driven through its public API.
+	 */
+	static bool MeasureGameMode(FAutomationTestBase& Test, TArray<FResult>& Results, const int32 Iterations)
+	{
+		const TSubclassOf<ATrickyGameModeBase> GameModeClass = FTrickyHeadlessWorld::ParseGameModeClass(
+			FCommandLine::Get());
+		const FTrickyHeadlessWorld HeadlessWorld(GameModeClass);
+		ATrickyGameModeBase* GameMode = HeadlessWorld.GetGameMode();
+
+		if (!IsValid(GameMode))
+		{
+			Test.AddError(FString::Printf(TEXT("Can't create a headless world with %s"), *GetNameSafe(GameModeClass)));
+			return false;
+		}
+
+		// The world isn't ticked, so the timers never finish the session.
+		GameMode->SetIsSessionTimeLimited(true);
+		GameMode->SetGameDuration(1000.f);
+
+		const FGameStateControllerCaller Caller(GameMode);
+		Caller.StartGame();
+
+		Measure(Results, TEXT("Transition.Execute"), 0, Iterations, 2, [GameMode]
+		{
+			IGameStateControllerInterface::Execute_StopGame(GameMode, EGameInactivityReason::Paused);
+			IGameStateControllerInterface::Execute_StartGame(GameMode);
+		});
+
+		Measure(Results, TEXT("Transition.Caller"), 0, Iterations, 2, [&Caller]
+		{
+			Caller.StopGame(EGameInactivityReason::Paused);
+			Caller.StartGame();
+		});
+
+		Measure(Results, TEXT("Transition.Direct"), 0, Iterations, 2, [GameMode]
+		{
+			GameMode->StopGame_Implementation(EGameInactivityReason::Paused);
+			GameMode->StartGame_Implementation();
+		});
+
+		Measure(Results, TEXT("Library.GetGameState"), 0, Iterations, 1, [GameMode]
+		{
+			UTrickyGameModeLibrary::GetGameState(GameMode);
+		});
+
+		Measure(Results, TEXT("Library.GetInactivityReason"), 0, Iterations, 1, [GameMode]
+		{
+			UTrickyGameModeLibrary::GetInactivityReason(GameMode);
+		});
+
+		Measure(Results, TEXT("Library.GetGameElapsedTime"), 0, Iterations, 1, [GameMode]
+		{
+			UTrickyGameModeLibrary::GetGameElapsedTime(GameMode);
+		});
+
+		Measure(Results, TEXT("Library.GetGameRemainingTime"), 0, Iterations, 1, [GameMode]
+		{
+			UTrickyGameModeLibrary::GetGameRemainingTime(GameMode);
+		});
+
+		// Stopping a running game doesn't start the preparation timer, so the timers are restarted by a rematch
+		// which stops both of them and enters the preparation again.
+		GameMode->SetInitialInactivityReason(EGameInactivityReason::Preparation);
+		GameMode->SetPreparationDuration(1000.f);
+
+		Measure(Results, TEXT("Timer.Rematch"), 0, Iterations, 2, [GameMode, &Caller]
+		{
+			GameMode->Rematch();
+			Caller.StartGame();
+		});
+
+		return true;
+	}
+
+	/**
+	 * Measures native and dynamic delegates and the transition dispatcher with different numbers of listeners.
+	 */
+	static void MeasureBroadcasts(TArray<FResult>& Results, const int32 Iterations)
+	{
+		FTrickyGameStateTransition Transition;
+		Transition.FromState = ETrickyGameState::Active;
+		Transition.ToState = ETrickyGameState::Inactive;
+		Transition.ToReason = EGameInactivityReason::Paused;
+
+		for (const int32 ListenersNum : ListenersNums)
+		{
+			// Keeps the number of invoked listeners roughly the same for every size.
+			const int32 BroadcastIterations = FMath::Max(Iterations / ListenersNum, 10);
+			int32 CallsNum = 0;
+
+			FOnGameStateTransitionSignature NativeDelegate;
+			FOnGameStateChangedDynamicSignature DynamicDelegate;
+			FTrickyTransitionDispatcher Dispatcher;
+			FTrickyTransitionDispatcher FilteredDispatcher;
+			TArray<UTrickyGameModeBenchmarkListener*> Listeners;
+			Listeners.Reserve(ListenersNum);
+
+			for (int32 Index = 0; Index < ListenersNum; ++Index)
+			{
+				NativeDelegate.AddLambda([&CallsNum](const FTrickyGameStateTransition&) { ++CallsNum; });
+
+				UTrickyGameModeBenchmarkListener* Listener = NewObject<UTrickyGameModeBenchmarkListener>();
+				Listener->AddToRoot();
+				DynamicDelegate.AddDynamic(Listener, &UTrickyGameModeBenchmarkListener::HandleGameStateChanged);
+				Listeners.Add(Listener);
+
+				Dispatcher.Subscribe(FTrickyTransitionFilter(),
+				                     FOnGameStateTransitionSignature::FDelegate::CreateLambda(
+					                     [&CallsNum](const FTrickyGameStateTransition&) { ++CallsNum; }));
+
+				// Listeners of another edge, the transition shouldn't visit them at all.
+				FilteredDispatcher.Subscribe(FTrickyTransitionFilter::MakeEdge(ETrickyGameState::Active,
+				                                                               ETrickyGameState::Finished),
+				                             FOnGameStateTransitionSignature::FDelegate::CreateLambda(
+					                             [&CallsNum](const FTrickyGameStateTransition&) { ++CallsNum; }));
+			}
+
+			Measure(Results, TEXT("Broadcast.Native"), ListenersNum, BroadcastIterations, 1, [&]
+			{
+				NativeDelegate.Broadcast(Transition);
+			});
+
+			Measure(Results, TEXT("Broadcast.Dynamic"), ListenersNum, BroadcastIterations, 1, [&]
+			{
+				DynamicDelegate.Broadcast(ETrickyGameState::Inactive);
+			});
+
+			Measure(Results, TEXT("Broadcast.Dispatcher"), ListenersNum, BroadcastIterations, 1, [&]
+			{
+				Dispatcher.Dispatch(Transition);
+			});
+
+			Measure(Results, TEXT("Broadcast.DispatcherOtherEdge"), ListenersNum, BroadcastIterations, 1, [&]
+			{
+				FilteredDispatcher.Dispatch(Transition);
+			});
+
+			for (UTrickyGameModeBenchmarkListener* Listener : Listeners)
+			{
+				Listener->RemoveFromRoot();
+			}
+		}
+	}
+}
+
+/**
+ * Measures the cost of transitions, library calls, timers and event broadcasts of TrickyGameModeBase
+ * in a headless world and saves the results as JSON, so they can be compared between builds.
+ *
+ * Optional command line parameters: -BenchmarkIterations=10000 -BenchmarkOutput=<Path>.json
+ * -GameMode=/Script/Module.ClassName
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FTrickyGameModeBenchmarkTest,
+                                  "TrickyGameMode.Benchmark",
+                                  EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+void FTrickyGameModeBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	OutBeautifiedNames.Add(TEXT("GameMode"));
+	OutTestCommands.Add(TEXT("GameMode"));
+	OutBeautifiedNames.Add(TEXT("Broadcasts"));
+	OutTestCommands.Add(TEXT("Broadcasts"));
+}
+
+bool FTrickyGameModeBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace TrickyGameModeBenchmark;
+
+	int32 Iterations = 10000;
+	FParse::Value(FCommandLine::Get(), TEXT("BenchmarkIterations="), Iterations);
+	Iterations = FMath::Max(Iterations, 1);
+
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Profiling") /
+		FString::Printf(TEXT("TrickyGameModeBenchmark-%s-%s.json"), *Parameters, *FDateTime::Now().ToString());
+	FParse::Value(FCommandLine::Get(), TEXT("BenchmarkOutput="), OutputPath);
+
+	TArray<FResult> Results;
+
+	{
+		// The state change logs would dominate the measurements.
+		LOG_SCOPE_VERBOSITY_OVERRIDE(LogTrickyGameMode, ELogVerbosity::Warning);
+
+		if (Parameters == TEXT("GameMode"))
+		{
+			if (!MeasureGameMode(*this, Results, Iterations))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			MeasureBroadcasts(Results, Iterations);
+		}
+	}
+
+	for (const FResult& Result : Results)
+	{
+		AddInfo(FString::Printf(TEXT("%-32s listeners %5d: median %10.1f ns, min %10.1f ns"),
+		                        *Result.Name,
+		                        Result.ListenersNum,
+		                        Result.MedianNs,
+		                        Result.MinNs));
+	}
+
+	if (!SaveResults(Results, Iterations, OutputPath))
+	{
+		AddError(FString::Printf(TEXT("Can't save the benchmark results to %s"), *OutputPath));
+		return false;
+	}
+
+	AddInfo(FString::Printf(TEXT("Benchmark results saved to %s"), *OutputPath));
+	return true;
+}
+
+#endif
@@ -0,0 +1,330 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyGameModeSimulationCommandlet.h"
+
+#include "TrickyGameModeBase.h"
+#include "TrickyGameStateBase.h"
+#include "TrickyHeadlessWorld.h"
+#include "TimerManager.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "Logging/LogScopedVerbosityOverride.h"
+#include "UObject/UObjectArray.h"
+
+namespace TrickyGameModeSimulation
+{
+	/**
+	 * Chance of a random action on each step, per simulated second.
+	 */
+	static constexpr float ActionRate = 0.2f;
+
+	static constexpr int32 MaxLoggedViolationsNum = 20;
+
+	/**
+	 * Steps a single cycle can take before it's considered stuck.
+	 */
+	static constexpr int32 MaxCycleStepsNum = 1000000;
+
+	/**
+	 * Checks that the game mode, its game state and its timers agree with each other.
+	 *
+	 * @return An empty string if every invariant holds, the description of the first violated one otherwise.
+	 */
+	static FString CheckInvariants(const ATrickyGameModeBase* GameMode)
+	{
+		const ETrickyGameState State = GameMode->GetCurrentState();
+		const EGameInactivityReason Reason = GameMode->GetCurrentInactivityReason();
+
+		if (State == ETrickyGameState::Inactive && Reason == EGameInactivityReason::None)
+		{
+			return TEXT("The game is inactive without a reason");
+		}
+
+		if (State != ETrickyGameState::Inactive
+			&& IGameStateControllerInterface::Execute_GetGameInactivityReason(GameMode) != EGameInactivityReason::None)
+		{
+			return FString::Printf(TEXT("The game is %s with inactivity reason %s"),
+			                       LexToString(State),
+			                       LexToString(Reason));
+		}
+
+		if (State == ETrickyGameState::Finished
+			&& IGameStateControllerInterface::Execute_GetGameResult(GameMode) == EGameResult::None)
+		{
+			return TEXT("The game is finished without a result");
+		}
+
+		// State changes don't pause the timers, and the simulation never pauses them directly.
+		const FTimerManager& TimerManager = GameMode->GetWorldTimerManager();
+		const FTimerHandle PreparationTimerHandle = GameMode->GetPreparationTimerHandle();
+		const FTimerHandle GameTimerHandle = GameMode->GetSessionTimerHandle();
+		const bool bIsPreparationTimerAlive = TimerManager.TimerExists(PreparationTimerHandle);
+
+		if (bIsPreparationTimerAlive && !TimerManager.IsTimerActive(PreparationTimerHandle))
+		{
+			return FString::Printf(TEXT("The preparation timer is paused while the game is %s with reason %s"),
+			                       LexToString(State),
+			                       LexToString(Reason));
+		}
+
+		if (TimerManager.TimerExists(GameTimerHandle) && !TimerManager.IsTimerActive(GameTimerHandle))
+		{
+			return FString::Printf(TEXT("The game timer is paused while the game is %s"), LexToString(State));
+		}
+
+		const ATrickyGameStateBase* GameState = GameMode->GetGameState<ATrickyGameStateBase>();
+
+		if (!IsValid(GameState))
+		{
+			return FString();
+		}
+
+		const FTrickyReplicatedGameState& ReplicatedState = GameState->GetReplicatedState();
+
+		if (ReplicatedState.State != State || ReplicatedState.InactivityReason != Reason)
+		{
+			return FString::Printf(TEXT("The game state has %s/%s while the game mode has %s/%s"),
+			                       LexToString(ReplicatedState.State),
+			                       LexToString(ReplicatedState.InactivityReason),
+			                       LexToString(State),
+			                       LexToString(Reason));
+		}
+
+		if (GameState->GetPreparationTimer().IsActive() != bIsPreparationTimerAlive)
+		{
+			return TEXT("The replicated preparation timer doesn't match the preparation timer");
+		}
+
+		// Sessions without a time limit measure the game time without a timer.
+		if (GameMode->GetIsSessionTimeLimited()
+			&& GameState->GetGameTimer().IsActive() != TimerManager.TimerExists(GameTimerHandle))
+		{
+			return TEXT("The replicated game timer doesn't match the game timer");
+		}
+
+		return FString();
+	}
+
+	/**
+	 * Makes a random action allowed in the current state.
+	 */
+	static void MakeRandomAction(ATrickyGameModeBase* GameMode,
+	                             const FGameStateControllerCaller& Caller,
+	                             const FRandomStream& Random)
+	{
+		const float Roll = Random.FRand();
+
+		switch (GameMode->GetCurrentState())
+		{
+		case ETrickyGameState::Active:
+			if (Roll < 0.3f)
+			{
+				GameMode->SetPause(nullptr);
+			}
+			else if (Roll < 0.55f)
+			{
+				Caller.StartCutscene();
+			}
+			else if (Roll < 0.7f)
+			{
+				Caller.StartTransition();
+			}
+			else if (Roll < 0.85f)
+			{
+				Caller.StartPreparation();
+			}
+			else
+			{
+				const EGameResult Results[] = {EGameResult::Win, EGameResult::Loose, EGameResult::Draw};
+				Caller.FinishGame(Results[Random.RandHelper(UE_ARRAY_COUNT(Results))]);
+			}
+			break;
+
+		case ETrickyGameState::Inactive:
+			switch (GameMode->GetCurrentInactivityReason())
+			{
+			case EGameInactivityReason::Paused:
+				GameMode->ClearPause();
+				break;
+
+			case EGameInactivityReason::Preparation:
+				if (Roll < 0.5f)
+				{
+					Caller.StartCutscene();
+				}
+				else if (!GameMode->GetWorldTimerManager().TimerExists(GameMode->GetPreparationTimerHandle()))
+				{
+					// StartPreparation doesn't start the timer when it stops a running or finished game.
+					Caller.StartGame();
+				}
+				break;
+
+			case EGameInactivityReason::Transition:
+				Caller.StartPreparation();
+				break;
+
+			default:
+				Caller.StartGame();
+				break;
+			}
+			break;
+
+		case ETrickyGameState::Finished:
+			break;
+		}
+	}
+}
+
+UTrickyGameModeSimulationCommandlet::UTrickyGameModeSimulationCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = true;
+	LogToConsole = true;
+}
+
+int32 UTrickyGameModeSimulationCommandlet::Main(const FString& Params)
+{
+	using namespace TrickyGameModeSimulation;
+
+	int32 CyclesNum = 1000;
+	FParse::Value(*Params, TEXT("Cycles="), CyclesNum);
+
+	float TimeStep = 0.1f;
+	FParse::Value(*Params, TEXT("TimeStep="), TimeStep);
+	TimeStep = FMath::Max(TimeStep, UE_KINDA_SMALL_NUMBER);
+
+	int32 Seed = 0;
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	const FRandomStream Random(Seed);
+
+	const TSubclassOf<ATrickyGameModeBase> GameModeClass = FTrickyHeadlessWorld::ParseGameModeClass(*Params);
+
+	if (!GameModeClass)
+	{
+		return 1;
+	}
+
+	const FTrickyHeadlessWorld HeadlessWorld(GameModeClass);
+	ATrickyGameModeBase* GameMode = HeadlessWorld.GetGameMode();
+
+	if (!IsValid(GameMode))
+	{
+		UE_LOG(LogTrickyGameMode, Error, TEXT("Can't create a headless world with %s"), *GetNameSafe(GameModeClass));
+		return 1;
+	}
+
+	float PreparationDuration = GameMode->GetPreparationDuration();
+	FParse::Value(*Params, TEXT("PreparationDuration="), PreparationDuration);
+	GameMode->SetPreparationDuration(PreparationDuration);
+
+	float GameDuration = GameMode->GetGameDuration();
+
+	if (FParse::Value(*Params, TEXT("GameDuration="), GameDuration))
+	{
+		GameMode->SetIsSessionTimeLimited(true);
+		GameMode->SetGameDuration(GameDuration);
+	}
+
+	int64 TransitionsNum = 0;
+	GameMode->SubscribeToTransition(FTrickyTransitionFilter(),
+	                                FOnGameStateTransitionSignature::FDelegate::CreateLambda(
+		                                [&TransitionsNum](const FTrickyGameStateTransition&) { ++TransitionsNum; }));
+
+	const FGameStateControllerCaller Caller(GameMode);
+	const float ActionChance = FMath::Min(ActionRate * TimeStep, 1.f);
+	int32 ViolationsNum = 0;
+	int64 StepsNum = 0;
+	int32 FinishedCyclesNum = 0;
+	int32 InitialObjectsNum = 0;
+	uint64 InitialUsedMemory = 0;
+	const double StartTime = FPlatformTime::Seconds();
+
+	{
+		// The state change logs would flood the output, violations are logged as errors.
+		LOG_SCOPE_VERBOSITY_OVERRIDE(LogTrickyGameMode, ELogVerbosity::Warning);
+
+		for (int32 Cycle = 0; Cycle < CyclesNum && ViolationsNum == 0; ++Cycle)
+		{
+			Caller.StartPreparation();
+			int32 CycleStepsNum = 0;
+
+			while (GameMode->GetCurrentState() != ETrickyGameState::Finished)
+			{
+				if (++CycleStepsNum > MaxCycleStepsNum)
+				{
+					UE_LOG(LogTrickyGameMode,
+					       Error,
+					       TEXT("Cycle %d is stuck in %s/%s"),
+					       Cycle,
+					       LexToString(GameMode->GetCurrentState()),
+					       LexToString(GameMode->GetCurrentInactivityReason()));
+					++ViolationsNum;
+					break;
+				}
+
+				HeadlessWorld.Tick(TimeStep);
+				++StepsNum;
+
+				if (Random.FRand() < ActionChance)
+				{
+					MakeRandomAction(GameMode, Caller, Random);
+				}
+
+				const FString Violation = CheckInvariants(GameMode);
+
+				if (!Violation.IsEmpty())
+				{
+					if (++ViolationsNum <= MaxLoggedViolationsNum)
+					{
+						UE_LOG(LogTrickyGameMode, Error, TEXT("Cycle %d, step %d: %s"), Cycle, CycleStepsNum, *Violation);
+					}
+				}
+			}
+
+			++FinishedCyclesNum;
+
+			// The first cycle warms up the pools and allocators, the memory growth is measured from its end.
+			if (Cycle == 0)
+			{
+				InitialObjectsNum = GUObjectArray.GetObjectArrayNumMinusAvailable();
+				InitialUsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+			}
+		}
+	}
+
+	const double Duration = FPlatformTime::Seconds() - StartTime;
+	const double SimulatedTime = static_cast<double>(StepsNum) * TimeStep;
+	const int32 ObjectsGrowth = GUObjectArray.GetObjectArrayNumMinusAvailable() - InitialObjectsNum;
+	const int64 MemoryGrowth = static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) - static_cast<int64>(InitialUsedMemory);
+
+	UE_LOG(LogTrickyGameMode,
+	       Display,
+	       TEXT("Simulated %d cycles, %lld steps, %lld transitions, %.0f s of game time in %.2f s (x%.0f)"),
+	       FinishedCyclesNum,
+	       StepsNum,
+	       TransitionsNum,
+	       SimulatedTime,
+	       Duration,
+	       Duration > 0.0 ? SimulatedTime / Duration : 0.0);
+	UE_LOG(LogTrickyGameMode,
+	       Display,
+	       TEXT("Throughput: %.1f cycles/s, %.0f steps/s, %.0f transitions/s"),
+	       Duration > 0.0 ? FinishedCyclesNum / Duration : 0.0,
+	       Duration > 0.0 ? StepsNum / Duration : 0.0,
+	       Duration > 0.0 ? TransitionsNum / Duration : 0.0);
+	UE_LOG(LogTrickyGameMode,
+	       Display,
+	       TEXT("Growth after the first cycle: %d objects, %.2f MB of used physical memory"),
+	       ObjectsGrowth,
+	       MemoryGrowth / (1024.0 * 1024.0));
+
+	if (ViolationsNum > 0)
+	{
+		UE_LOG(LogTrickyGameMode, Error, TEXT("%d invariant violations"), ViolationsNum);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,26 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TrickyGameModeSimulationCommandlet.generated.h"
+
+/**
+ * Drives full Preparation -> Active -> Finished cycles of a TrickyGameModeBase class in a headless world
+ * with randomized pauses, cutscenes and transitions. The world is advanced with a fixed time step as fast as possible,
+ * the state machine invariants are checked after every step.
+ *
+ * Usage: UnrealEditor-Cmd.exe <Project> -run=TrickyGameModeSimulation -nullrhi [-Cycles=1000] [-TimeStep=0.1]
+ * [-Seed=0] [-PreparationDuration=3] [-GameDuration=30] [-GameMode=/Script/Module.ClassName]
+ */
+UCLASS()
+class UTrickyGameModeSimulationCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTrickyGameModeSimulationCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,116 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TimerManager.h"
+#include "TrickyGameModeBase.h"
+#include "TrickyHeadlessWorld.h"
+#include "Engine/World.h"
+#include "Logging/LogScopedVerbosityOverride.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace TrickyGameTimeBaseline
+{
+	static constexpr float TimeStep = 1.f;
+
+	static constexpr float Tolerance = 1e-3f;
+
+	/**
+	 * Computes the game time the way the game mode did before the session clock:
+	 * from the timer manager for time-limited sessions, from the last StartGame otherwise.
+	 */
+	struct FBaseline
+	{
+		double StartGameTime = 0.0;
+
+		float GetElapsed(const ATrickyGameModeBase* GameMode) const
+		{
+			return GameMode->GetIsSessionTimeLimited()
+				       ? GameMode->GetWorldTimerManager().GetTimerElapsed(GameMode->GetSessionTimerHandle())
+				       : static_cast<float>(GameMode->GetWorld()->GetTimeSeconds() - StartGameTime);
+		}
+
+		float GetRemaining(const ATrickyGameModeBase* GameMode) const
+		{
+			return GameMode->GetIsSessionTimeLimited()
+				       ? GameMode->GetWorldTimerManager().GetTimerRemaining(GameMode->GetSessionTimerHandle())
+				       : static_cast<float>(GameMode->GetWorld()->GetTimeSeconds() - StartGameTime);
+		}
+	};
+}
+
+/**
+ * Compares GetGameElapsedTime and GetGameRemainingTime with the values computed the old way in every state
+ * of a session with and without a time limit.
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FTrickyGameTimeBaselineTest,
+                                  "TrickyGameMode.GameTime.Baseline",
+                                  EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+void FTrickyGameTimeBaselineTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	OutBeautifiedNames.Add(TEXT("Unlimited"));
+	OutTestCommands.Add(TEXT("Unlimited"));
+	OutBeautifiedNames.Add(TEXT("Limited"));
+	OutTestCommands.Add(TEXT("Limited"));
+}
+
+bool FTrickyGameTimeBaselineTest::RunTest(const FString& Parameters)
+{
+	using namespace TrickyGameTimeBaseline;
+
+	LOG_SCOPE_VERBOSITY_OVERRIDE(LogTrickyGameMode, ELogVerbosity::Warning);
+
+	const FTrickyHeadlessWorld HeadlessWorld(ATrickyGameModeBase::StaticClass());
+	ATrickyGameModeBase* GameMode = HeadlessWorld.GetGameMode();
+
+	if (!TestNotNull(TEXT("Game mode"), GameMode))
+	{
+		return false;
+	}
+
+	GameMode->SetIsSessionTimeLimited(Parameters == TEXT("Limited"));
+	GameMode->SetGameDuration(100.f);
+
+	FBaseline Baseline;
+	GameMode->OnGameStartedNative.AddLambda([&Baseline, GameMode](const FTrickyGameStateTransition&)
+	{
+		Baseline.StartGameTime = GameMode->GetWorld()->GetTimeSeconds();
+	});
+
+	const FGameStateControllerCaller Caller(GameMode);
+	auto CheckState = [this, GameMode, &Baseline, &Caller](const TCHAR* StateName)
+	{
+		TestEqual(FString::Printf(TEXT("Elapsed time in %s"), StateName),
+		          Caller.GetGameElapsedTime(),
+		          Baseline.GetElapsed(GameMode),
+		          Tolerance);
+		TestEqual(FString::Printf(TEXT("Remaining time in %s"), StateName),
+		          Caller.GetGameRemainingTime(),
+		          Baseline.GetRemaining(GameMode),
+		          Tolerance);
+	};
+
+	HeadlessWorld.Tick(TimeStep);
+	CheckState(TEXT("Preparation"));
+
+	Caller.StartGame();
+	HeadlessWorld.Tick(TimeStep);
+	CheckState(TEXT("Active"));
+
+	Caller.StopGame(EGameInactivityReason::Paused);
+	HeadlessWorld.Tick(TimeStep);
+	CheckState(TEXT("Paused"));
+
+	Caller.StartGame();
+	HeadlessWorld.Tick(TimeStep);
+	CheckState(TEXT("Resumed"));
+
+	Caller.FinishGame(EGameResult::Win);
+	HeadlessWorld.Tick(TimeStep);
+	CheckState(TEXT("Finished"));
+	return true;
+}
+
+#endif
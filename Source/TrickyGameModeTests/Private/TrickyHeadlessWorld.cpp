@@ -0,0 +1,97 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+
+#include "TrickyHeadlessWorld.h"
+
+#include "EngineUtils.h"
+#include "TrickyGameModeBase.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+FTrickyHeadlessWorld::FTrickyHeadlessWorld(const TSubclassOf<ATrickyGameModeBase>& GameModeClass)
+{
+	if (!GEngine || !GameModeClass)
+	{
+		return;
+	}
+
+	GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->AddToRoot();
+	GameInstance->InitializeStandalone(TEXT("TrickyHeadlessWorld"));
+	World = GameInstance->GetWorld();
+
+	if (!World)
+	{
+		return;
+	}
+
+	FURL URL;
+	URL.AddOption(*FString::Printf(TEXT("game=%s"), *GameModeClass->GetPathName()));
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+}
+
+FTrickyHeadlessWorld::~FTrickyHeadlessWorld()
+{
+	if (World)
+	{
+		World->BeginTearingDown();
+
+		for (FActorIterator It(World); It; ++It)
+		{
+			It->RouteEndPlay(EEndPlayReason::Quit);
+		}
+	}
+
+	if (GameInstance)
+	{
+		GameInstance->Shutdown();
+		GameInstance->RemoveFromRoot();
+	}
+
+	if (World && GEngine)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+ATrickyGameModeBase* FTrickyHeadlessWorld::GetGameMode() const
+{
+	return World ? World->GetAuthGameMode<ATrickyGameModeBase>() : nullptr;
+}
+
+void FTrickyHeadlessWorld::Tick(const float DeltaSeconds) const
+{
+	if (!World)
+	{
+		return;
+	}
+
+	// The timer manager ticks only once per engine frame.
+	++GFrameCounter;
+	World->Tick(LEVELTICK_All, DeltaSeconds);
+}
+
+TSubclassOf<ATrickyGameModeBase> FTrickyHeadlessWorld::ParseGameModeClass(const TCHAR* Params)
+{
+	FString GameModeClassPath;
+
+	if (!FParse::Value(Params, TEXT("GameMode="), GameModeClassPath))
+	{
+		return ATrickyGameModeBase::StaticClass();
+	}
+
+	TSubclassOf<ATrickyGameModeBase> GameModeClass = LoadClass<ATrickyGameModeBase>(nullptr, *GameModeClassPath);
+
+	if (!GameModeClass)
+	{
+		UE_LOG(LogTrickyGameMode, Error, TEXT("Can't load game mode class %s"), *GameModeClassPath);
+	}
+
+	return GameModeClass;
+}
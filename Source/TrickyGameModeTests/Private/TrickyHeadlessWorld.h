@@ -0,0 +1,46 @@
+﻿// MIT License Copyright (c) Artyom "Tricky Fat Cat" Volkov
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ATrickyGameModeBase;
+class UGameInstance;
+class UWorld;
+
+/**
+ * A standalone game world without a map, viewport and players, used by the tests and the commandlets.
+ * The world is created with the given game mode, begins play and is destroyed with this object.
+ */
+class FTrickyHeadlessWorld
+{
+public:
+	explicit FTrickyHeadlessWorld(const TSubclassOf<ATrickyGameModeBase>& GameModeClass);
+
+	~FTrickyHeadlessWorld();
+
+	FTrickyHeadlessWorld(const FTrickyHeadlessWorld&) = delete;
+
+	FTrickyHeadlessWorld& operator=(const FTrickyHeadlessWorld&) = delete;
+
+	FORCEINLINE UWorld* GetWorld() const { return World; }
+
+	ATrickyGameModeBase* GetGameMode() const;
+
+	/**
+	 * Advances the world and its timers by a fixed time step.
+	 */
+	void Tick(const float DeltaSeconds) const;
+
+	/**
+	 * Loads the game mode class passed as -GameMode=/Script/Module.ClassName.
+	 *
+	 * @return ATrickyGameModeBase if the class isn't passed, nullptr if it can't be loaded.
+	 */
+	static TSubclassOf<ATrickyGameModeBase> ParseGameModeClass(const TCHAR* Params);
+
+private:
+	UGameInstance* GameInstance = nullptr;
+
+	UWorld* World = nullptr;
+};